@@ -0,0 +1,48 @@
+/* bound_function.h                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   Handle to a function whose overload was resolved ahead of time.
+
+   Calling a function through Type or Value requires a name lookup followed by
+   an overload resolution for every call. When the same function is called
+   over and over with the same signature, that work can be done once by binding
+   the signature which yields a handle that calls the selected overload
+   directly.
+
+*/
+
+#include "reflect.h"
+#pragma once
+
+namespace reflect {
+
+/******************************************************************************/
+/* BOUND FUNCTION                                                             */
+/******************************************************************************/
+
+template<typename Fn> struct BoundFunction;
+
+template<typename Ret, typename... Args>
+struct BoundFunction<Ret(Args...)>
+{
+    BoundFunction() : fn(nullptr), isDirect(false) {}
+    BoundFunction(const Function* fn, bool isDirect) :
+        fn(fn), isDirect(isDirect)
+    {}
+
+    explicit operator bool() const { return fn; }
+    const Function& function() const { return *fn; }
+
+    Ret operator() (Args... args) const
+    {
+        if (isDirect) return fn->invokeDirect<Ret>(std::forward<Args>(args)...);
+        return fn->invoke<Ret>(std::forward<Args>(args)...);
+    }
+
+private:
+    const Function* fn;
+    bool isDirect;
+};
+
+} // reflect
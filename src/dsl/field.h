@@ -104,15 +104,49 @@ template<typename...>
 void reflectMember(...) {}
 
 
+/******************************************************************************/
+/* REFLECT FIELD OFFSET                                                       */
+/******************************************************************************/
+
+/** Records the offset of a non-const data member within Obj which allows the
+    member to be accessed in place. Members inherited from a parent are skipped
+    since their offset is relative to the parent and not to Obj.
+
+    The object is never constructed, only its storage is used to compute the
+    address of the member.
+ */
+template<typename Obj, typename T,
+    class = typename std::enable_if<
+        IsMemberPtr<T, Obj>::value && !std::is_const<T>::value>::type>
+void reflectFieldOffset(Type* type, std::string name, T Obj::* field)
+{
+    typename std::aligned_storage<sizeof(Obj), alignof(Obj)>::type storage;
+
+    const char* base = reinterpret_cast<const char*>(&storage);
+    const Obj* obj = reinterpret_cast<const Obj*>(&storage);
+    size_t offset = reinterpret_cast<const char*>(&(obj->*field)) - base;
+
+    type->setFieldOffset(name, offset);
+}
+
+// Used to disambiguate fields that have both getter and setter.
+template<typename Obj, typename T, typename Other>
+void reflectFieldOffset(Type*, std::string, void (Other::*)(T)) {}
+
+template<typename...>
+void reflectFieldOffset(...) {}
+
+
 /******************************************************************************/
 /* REFLECT FIELD                                                              */
 /******************************************************************************/
 
-#define reflectField(field)                                     \
-    do {                                                        \
-        reflect::reflectGetter(type_, #field, &T_::field);      \
-        reflect::reflectSetter(type_, #field, &T_::field);      \
-        reflect::reflectMember(type_, #field, &T_::field);      \
+#define reflectField(field)                                             \
+    do {                                                                \
+        reflect::reflectGetter(type_, #field, &T_::field);              \
+        reflect::reflectSetter(type_, #field, &T_::field);              \
+        reflect::reflectMember(type_, #field, &T_::field);              \
+        reflect::reflectFieldOffset<T_>(type_, #field, &T_::field);     \
     } while(false)
 
 
@@ -14,13 +14,16 @@ namespace reflect {
 /* REFLECT TEMPLATE LOADER                                                    */
 /******************************************************************************/
 
-#define reflectTemplateLoader()                 \
-    static void loader()                        \
-    {                                           \
-        static bool loaded = false;             \
-        if (loaded) return;                     \
-        loaded = true;                          \
-        Registry::add<T_>();                    \
+// Registry::add() is idempotent so the flag is only there to skip the registry
+// lock once the loader was added. Threads racing on the first call will all
+// take the lock which is fine.
+#define reflectTemplateLoader()                                 \
+    static void loader()                                        \
+    {                                                           \
+        static std::atomic<bool> added(false);                  \
+        if (added.load(std::memory_order_acquire)) return;      \
+        Registry::add<T_>();                                    \
+        added.store(true, std::memory_order_release);           \
     }
 
 
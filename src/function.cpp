@@ -106,6 +106,38 @@ test(const Argument& ret, const std::vector<Argument>& args) const
             testArguments(args, this->args));
 }
 
+bool
+Function::
+isDirect(const Argument& ret, const std::vector<Argument>& args) const
+{
+    static const Type* valueType = type<Value>();
+
+    if (test(ret, args) != Match::Exact) return false;
+
+    // Values are matched exactly against anything but they still need to be
+    // boxed or unboxed so they have to go through the regular path.
+    if (!ret.isVoid()) {
+        if (ret.type() != this->ret.type()) return false;
+        if (ret.type() == valueType) return false;
+        if (ret.refType() == RefType::RValue) return false;
+        if (this->ret.refType() == RefType::RValue) return false;
+    }
+
+    for (size_t i = 0; i < args.size(); ++i) {
+        const Argument& arg = args[i];
+        const Argument& param = this->args[i];
+
+        if (arg.type() == valueType || param.type() == valueType) return false;
+
+        // Parameters taken by value are moved into so make sure that's what
+        // the caller asked for.
+        if (param.refType() == RefType::LValue) continue;
+        if (arg.refType() != RefType::RValue || arg.isConst()) return false;
+    }
+
+    return true;
+}
+
 
 bool
 Function::
@@ -141,7 +173,7 @@ const Type*
 Function::
 setterType() const
 {
-    if (!isGetter()) {
+    if (!isSetter()) {
         reflectError("function <%s, %s> is not a setter",
                 name_, signature(*this));
     }
@@ -54,6 +54,19 @@ struct Function
     template<typename Ret, typename... Args>
     Ret call(Args&&... args) const;
 
+    // Same as call() but skips the signature check. The caller is responsible
+    // for having tested the arguments beforehand.
+    template<typename Ret, typename... Args>
+    Ret invoke(Args&&... args) const;
+
+    // Same as invoke() but hands the arguments over to the function without
+    // boxing them in Value objects. Only valid if isDirect() holds for the
+    // signature of the call.
+    template<typename Ret, typename... Args>
+    Ret invokeDirect(Args&&... args) const;
+
+    bool isDirect(const Argument& ret, const std::vector<Argument>& args) const;
+
     bool isGetter() const;
     const Type* getterType() const;
 
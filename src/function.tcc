@@ -69,36 +69,23 @@ std::vector<Argument> reflectArguments()
 /* REFLECT ARGUMENTS                                                          */
 /******************************************************************************/
 
-inline void reflectArguments(std::vector<Argument>&) {}
+inline Argument reflectArgument(Value& value) { return value.argument(); }
+inline Argument reflectArgument(const Value& value) { return value.argument(); }
+inline Argument reflectArgument(Value&& value) { return value.argument(); }
 
-template<typename... Rest>
-void reflectArguments(
-        std::vector<Argument>& args, Value& value, Rest&&... rest)
+template<typename Arg>
+Argument reflectArgument(Arg&& arg)
 {
-    args.emplace_back(value.argument());
-    reflectArguments(args, std::forward<Rest>(rest)...);
+    return Argument::make(std::forward<Arg>(arg));
 }
 
-template<typename... Rest>
-void reflectArguments(
-        std::vector<Argument>& args, const Value& value, Rest&&... rest)
-{
-    args.emplace_back(value.argument());
-    reflectArguments(args, std::forward<Rest>(rest)...);
-}
 
-template<typename... Rest>
-void reflectArguments(
-        std::vector<Argument>& args, Value&& value, Rest&&... rest)
-{
-    args.emplace_back(value.argument());
-    reflectArguments(args, std::forward<Rest>(rest)...);
-}
+inline void reflectArguments(std::vector<Argument>&) {}
 
 template<typename Arg, typename... Rest>
 void reflectArguments(std::vector<Argument>& args, Arg&& arg, Rest&&... rest)
 {
-    args.emplace_back(Argument::make(std::forward<Arg>(arg)));
+    args.emplace_back(reflectArgument(std::forward<Arg>(arg)));
     reflectArguments(args, std::forward<Rest>(rest)...);
 }
 
@@ -111,6 +98,112 @@ std::vector<Argument> reflectArguments(Args&&... args)
 }
 
 
+/******************************************************************************/
+/* DIRECT ARGUMENTS                                                           */
+/******************************************************************************/
+
+inline void* directArgument(Value& value) { return value.value(); }
+inline void* directArgument(const Value& value) { return value.value(); }
+inline void* directArgument(Value&& value) { return value.value(); }
+
+template<typename Arg>
+void* directArgument(Arg&& arg)
+{
+    const void* ptr = &arg;
+    return const_cast<void*>(ptr);
+}
+
+
+/******************************************************************************/
+/* DIRECT RETURN                                                              */
+/******************************************************************************/
+
+namespace details {
+
+/** Counterpart of ValueFunctionBase::invoke() which fetches the return value
+    from the slot. Calls that return a Value or an r-value reference are never
+    made directly but must still compile.
+ */
+template<typename Ret>
+struct DirectReturn
+{
+    typedef typename std::remove_cv<Ret>::type T;
+
+    // The function behind fn isn't known at compile time so the slot must be
+    // able to hold either a pointer or a T whichever way isRef goes.
+    enum {
+        Size = sizeof(T) > sizeof(void*) ? sizeof(T) : sizeof(void*),
+        Align = alignof(T) > alignof(void*) ? alignof(T) : alignof(void*),
+    };
+    typedef typename std::aligned_storage<Size, Align>::type Slot;
+
+    template<typename Fn>
+    static Ret call(Fn& fn, bool isRef, void** args)
+    {
+        Slot storage;
+        fn.invoke(&storage, args);
+
+        if (isRef) {
+            void* ptr = *reinterpret_cast<void**>(&storage);
+            return copy(*static_cast<T*>(ptr),
+                    typename std::is_copy_constructible<T>::type());
+        }
+
+        struct Guard
+        {
+            T* ptr;
+            ~Guard() { ptr->~T(); }
+        } guard = { reinterpret_cast<T*>(&storage) };
+
+        return std::move_if_noexcept(*guard.ptr);
+    }
+
+private:
+
+    static Ret copy(T& value, std::true_type) { return value; }
+    static Ret copy(T&, std::false_type)
+    {
+        reflectError("<%s> cannot be copied", printArgument<Ret>());
+    }
+};
+
+template<typename Ret>
+struct DirectReturn<Ret&>
+{
+    template<typename Fn>
+    static Ret& call(Fn& fn, bool, void** args)
+    {
+        void* ptr;
+        fn.invoke(&ptr, args);
+        return *static_cast<Ret*>(ptr);
+    }
+};
+
+template<typename Ret>
+struct DirectReturn<Ret&&>
+{
+    template<typename Fn>
+    static Ret&& call(Fn& fn, bool, void** args)
+    {
+        void* ptr;
+        fn.invoke(&ptr, args);
+        return std::move(*static_cast<Ret*>(ptr));
+    }
+};
+
+template<>
+struct DirectReturn<void>
+{
+    template<typename Fn>
+    static void call(Fn& fn, bool, void** args)
+    {
+        fn.invoke(nullptr, args);
+    }
+};
+
+} // namespace details
+
+
 /******************************************************************************/
 /* FUNCTION                                                                   */
 /******************************************************************************/
@@ -162,6 +255,14 @@ call(Args&&... args) const
                 signature<Ret(Args...)>(), signature(*this));
     }
 
+    return invoke<Ret>(std::forward<Args>(args)...);
+}
+
+template<typename Ret, typename... Args>
+Ret
+Function::
+invoke(Args&&... args) const
+{
     typedef ValueFunction<sizeof...(Args)> Fn;
     Fn& typedFn = *static_cast<Fn*>(fn);
 
@@ -169,4 +270,20 @@ call(Args&&... args) const
     return retCast<Ret>(ret);
 }
 
+template<typename Ret, typename... Args>
+Ret
+Function::
+invokeDirect(Args&&... args) const
+{
+    typedef ValueFunction<sizeof...(Args)> Fn;
+    Fn& typedFn = *static_cast<Fn*>(fn);
+
+    // +1 avoids a zero sized array when there are no arguments.
+    void* params[sizeof...(Args) + 1] =
+        { directArgument(std::forward<Args>(args))..., nullptr };
+
+    bool isRef = ret.refType() == RefType::LValue;
+    return details::DirectReturn<Ret>::call(typedFn, isRef, params);
+}
+
 } // reflect
@@ -7,6 +7,8 @@
 
 #include "reflect.h"
 
+#include <algorithm>
+
 namespace reflect {
 
 /******************************************************************************/
@@ -25,7 +27,14 @@ add(Function fn)
                 other.name(), signature(other));
     }
 
+    // Adding an overload can change the outcome of a resolution so the cached
+    // resolutions are dropped.
+    std::lock_guard<std::mutex> guard(cacheLock);
+
     overloads.emplace_back(std::move(fn));
+
+    generation.fetch_add(1, std::memory_order_release);
+    cache.store(nullptr, std::memory_order_release);
 }
 
 bool
@@ -48,6 +57,133 @@ test(const Argument& ret, const std::vector<Argument>& args) const
     return false;
 }
 
+
+namespace {
+
+size_t hashArgument(size_t hash, const Argument& arg)
+{
+    size_t value = std::hash<const Type*>()(arg.type());
+    value ^= (size_t(arg.refType()) << 1) | arg.isConst();
+    return hash ^ (value + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+}
+
+} // namespace anonymous
+
+auto
+Overloads::
+resolve(const Argument& ret, const Argument* args, size_t n) const
+    -> Resolution
+{
+    size_t hash = hashArgument(n, ret);
+    for (size_t i = 0; i < n; ++i) hash = hashArgument(hash, args[i]);
+
+    return lookup(hash, ret, args, n);
+}
+
+Overloads::Cache::
+Cache() : size(0)
+{
+    for (auto& entry : entries) entry = nullptr;
+}
+
+auto
+Overloads::
+lookup(size_t hash, const Argument& ret, const Argument* args, size_t n) const
+    -> Resolution
+{
+    size_t gen = generation.load(std::memory_order_acquire);
+
+    if (const Cache* table = cache.load(std::memory_order_acquire)) {
+        for (const auto& slot : table->entries) {
+            const CacheEntry* entry = slot.load(std::memory_order_acquire);
+            if (!entry) break;
+
+            if (entry->hash != hash || entry->args.size() != n) continue;
+            if (!(entry->ret == ret)) continue;
+            if (!std::equal(args, args + n, entry->args.begin())) continue;
+
+            return entry->result;
+        }
+    }
+
+    CacheEntry entry;
+    entry.hash = hash;
+    entry.ret = ret;
+    entry.args.assign(args, args + n);
+
+    const Function* match = nullptr;
+    bool ambiguous = false;
+
+    for (const auto& fn : overloads) {
+
+        Match result = fn.test(entry.ret, entry.args);
+        if (result == Match::None) continue;
+
+        if (match && result == Match::Partial) {
+            ambiguous = true;
+            continue;
+        }
+
+        match = &fn;
+
+        if (result == Match::Exact) {
+            ambiguous = false;
+            break;
+        }
+    }
+
+    Resolution& result = entry.result;
+    result.fn = match;
+    result.isDirect = false;
+
+    if (!match) result.status = NoMatch;
+    else if (ambiguous) result.status = Ambiguous;
+    else {
+        result.status = Found;
+        result.isDirect = match->isDirect(entry.ret, entry.args);
+    }
+
+    Resolution copy = result;
+    insert(gen, std::move(entry));
+    return copy;
+}
+
+void
+Overloads::
+insert(size_t gen, CacheEntry entry) const
+{
+    std::lock_guard<std::mutex> guard(cacheLock);
+
+    // An overload was added while we were resolving.
+    if (gen != generation.load(std::memory_order_relaxed)) return;
+
+    // The published table is always the last one created.
+    Cache* table = cache.load(std::memory_order_relaxed) ?
+        caches.back().get() : nullptr;
+
+    if (!table) {
+        caches.emplace_back(new Cache);
+        table = caches.back().get();
+        cache.store(table, std::memory_order_release);
+    }
+
+    // Once full, the odd signatures are resolved the slow way instead of
+    // evicting the common ones.
+    if (table->size == CacheSize) return;
+
+    // Another thread may have raced us to the same signature.
+    for (size_t i = 0; i < table->size; ++i) {
+        const CacheEntry* other =
+            table->entries[i].load(std::memory_order_relaxed);
+        if (other->hash != entry.hash || other->args != entry.args) continue;
+        if (other->ret == entry.ret) return;
+    }
+
+    entries.emplace_back(new CacheEntry(std::move(entry)));
+    table->entries[table->size++].store(
+            entries.back().get(), std::memory_order_release);
+}
+
 bool
 Overloads::
 isField() const
@@ -16,6 +16,11 @@ namespace reflect {
 
 struct Overloads
 {
+    Overloads() : cache(nullptr), generation(0) {}
+
+    Overloads(const Overloads&) = delete;
+    Overloads& operator=(const Overloads&) = delete;
+
     // For debugging purposes only.
     std::string name() const;
 
@@ -30,9 +35,24 @@ struct Overloads
     bool test(const Function& fn) const;
     bool test(const Argument& ret, const std::vector<Argument>& args) const;
 
+    enum Status { Found, NoMatch, Ambiguous };
+
+    struct Resolution
+    {
+        Status status;
+        const Function* fn;
+        bool isDirect; // See Function::isDirect()
+    };
+
+    Resolution resolve(
+            const Argument& ret, const Argument* args, size_t n) const;
+
     template<typename Ret, typename... Args>
     Ret call(Args&&... args) const;
 
+    template<typename Fn>
+    BoundFunction<Fn> bind() const;
+
     bool isField() const;
     const Type* fieldType() const;
     bool hasGetter() const;
@@ -41,7 +61,52 @@ struct Overloads
     std::string print(size_t indent = 0) const;
 
 private:
-    std::vector<Function> overloads;
+
+    /** Caches the result of overload resolution for a given call signature.
+        Failed resolutions are also cached so that we can error out without
+        going through the whole resolution again.
+
+        Entries are published into a fixed-size table of atomic slots which
+        are only ever filled in so hits can be served without locking.
+        Adding an overload retires the current table and bumps the
+        generation which keeps resolutions computed against the old set of
+        overloads from being published. Retired tables and entries are kept
+        alive as a reader could still be walking them.
+     */
+    struct CacheEntry
+    {
+        size_t hash;
+        Argument ret;
+        std::vector<Argument> args;
+
+        Resolution result;
+    };
+
+    enum { CacheSize = 64 };
+
+    struct Cache
+    {
+        Cache();
+
+        size_t size; // Guarded by cacheLock.
+        std::atomic<const CacheEntry*> entries[CacheSize];
+    };
+
+    Resolution lookup(
+            size_t hash,
+            const Argument& ret, const Argument* args, size_t n) const;
+
+    void insert(size_t generation, CacheEntry entry) const;
+
+    // Functions are handed out by pointer so they must never be relocated.
+    std::deque<Function> overloads;
+
+    mutable std::atomic<const Cache*> cache;
+    mutable std::atomic<size_t> generation;
+
+    mutable std::mutex cacheLock;
+    mutable std::vector< std::unique_ptr<Cache> > caches;
+    mutable std::vector< std::unique_ptr<CacheEntry> > entries;
 };
 
 } // reflect
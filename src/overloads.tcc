@@ -31,44 +31,66 @@ Ret
 Overloads::
 call(Args&&... args) const
 {
-    const Function* bestFn = nullptr;
-    bool ambiguous = false;
+    // +1 avoids a zero sized array when there are no arguments.
+    const Argument ret = Argument::make<Ret>();
+    const Argument params[sizeof...(Args) + 1] =
+        { reflectArgument(std::forward<Args>(args))..., Argument() };
 
-    for (const auto& fn : overloads) {
+    Resolution result = resolve(ret, params, sizeof...(Args));
+
+    if (result.status == NoMatch) {
+        reflectError("no overloads available for <%s> for function <%s>",
+                signature(ret, { params, params + sizeof...(Args) }), name());
+    }
+
+    if (result.status == Ambiguous) {
+        reflectError("ambiguous function call <%s> for function <%s>",
+                signature(ret, { params, params + sizeof...(Args) }), name());
+    }
 
-        Match match = fn.testParams<Ret>(std::forward<Args>(args)...);
-        if (match == Match::None) continue;
+    if (result.isDirect)
+        return result.fn->invokeDirect<Ret>(std::forward<Args>(args)...);
+    return result.fn->invoke<Ret>(std::forward<Args>(args)...);
+}
 
-        if (bestFn && match == Match::Partial) {
-            ambiguous = true;
-            continue;
-        }
 
-        bestFn = &fn;
+namespace details {
 
-        if (match == Match::Exact) {
-            ambiguous = false;
-            break;
-        }
-    }
+template<typename Fn> struct BindSignature;
+
+template<typename Ret, typename... Args>
+struct BindSignature<Ret(Args...)>
+{
+    // Arguments are forwarded by the handle so we reflect them as such.
+    static Argument ret() { return Argument::make<Ret>(); }
+    static std::vector<Argument> args() { return { Argument::make<Args&&>()... }; }
+};
+
+} // namespace details
+
+template<typename Fn>
+BoundFunction<Fn>
+Overloads::
+bind() const
+{
+    typedef details::BindSignature<Fn> Signature;
+
+    Argument ret = Signature::ret();
+    std::vector<Argument> args = Signature::args();
+
+    Resolution result = resolve(ret, args.data(), args.size());
 
-    if (!bestFn) {
+    if (result.status == NoMatch) {
         reflectError("no overloads available for <%s> for function <%s>",
-                signature(
-                        Argument::make<Ret>(),
-                        reflectArguments(std::forward<Args>(args)...)),
-                name());
+                signature(ret, args), name());
     }
 
-    if (ambiguous) {
+    if (result.status == Ambiguous) {
         reflectError("ambiguous function call <%s> for function <%s>",
-                signature(
-                        Argument::make<Ret>(),
-                        reflectArguments(std::forward<Args>(args)...)),
-                name());
+                signature(ret, args), name());
     }
 
-    return bestFn->call<Ret>(std::forward<Args>(args)...);
+    return BoundFunction<Fn>(result.fn, result.isDirect);
 }
 
 } // reflect
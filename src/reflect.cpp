@@ -9,6 +9,8 @@
 
 #include "utils.cpp"
 #include "ref_type.cpp"
+#include "symbol.cpp"
+#include "trait.cpp"
 
 #include "registry.cpp"
 #include "argument.cpp"
@@ -19,10 +19,14 @@
 #include <functional>
 #include <type_traits>
 #include <vector>
+#include <deque>
 #include <unordered_map>
 #include <unordered_set>
+#include <mutex>
+#include <atomic>
 #include <stdexcept>
 #include <cstddef>
+#include <cstdint>
 
 #include <iostream> // debug only
 
@@ -31,6 +35,8 @@
 #include "ref_type.h"
 #include "type_vector.h"
 #include "function_type.h"
+#include "symbol.h"
+#include "trait.h"
 
 namespace reflect {
 
@@ -48,6 +54,7 @@ struct Overloads;
 #include "cast.h"
 #include "value_function.h"
 #include "function.h"
+#include "bound_function.h"
 #include "overloads.h"
 #include "type.h"
 #include "scope.h"
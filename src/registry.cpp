@@ -11,27 +11,156 @@
 
 namespace reflect {
 
+/******************************************************************************/
+/* TYPE TABLE                                                                 */
+/******************************************************************************/
+
+namespace {
+
+/** Hash table of the fully loaded types which can be read without holding any
+    locks.
+
+    Entries are only ever added and never modified or removed. Writers are
+    serialized by the registry lock and publish new entries by pushing them at
+    the head of their bucket's chain. Growing the table builds a brand new
+    bucket array which is then published in one go. Since entries and bucket
+    arrays are never freed, a reader holding an outdated array still sees a
+    consistent, if incomplete, view of the table.
+ */
+struct TypeTable
+{
+    TypeTable() : buckets(nullptr), size(0) {}
+
+    const Type* find(const std::string& id) const
+    {
+        const Buckets* table = buckets.load(std::memory_order_acquire);
+        if (!table) return nullptr;
+
+        size_t hash = std::hash<std::string>()(id);
+        const Entry* entry =
+            table->heads[hash & table->mask].load(std::memory_order_acquire);
+
+        for (; entry; entry = entry->next) {
+            if (entry->hash == hash && *entry->id == id) return entry->type;
+        }
+
+        return nullptr;
+    }
+
+    // Must be called with the registry lock held.
+    void insert(Symbol id, const Type* type)
+    {
+        if (find(id.str())) return;
+
+        const Buckets* table = buckets.load(std::memory_order_relaxed);
+        if (!table || size >= table->mask + 1)
+            table = grow(table);
+
+        size_t hash = std::hash<std::string>()(id.str());
+        auto& head = table->heads[hash & table->mask];
+
+        Entry* entry = newEntry(hash, &id.str(), type);
+        entry->next = head.load(std::memory_order_relaxed);
+        head.store(entry, std::memory_order_release);
+
+        size++;
+    }
+
+private:
+
+    struct Entry
+    {
+        size_t hash;
+        const std::string* id; // Owned by the symbol table.
+        const Type* type;
+        const Entry* next;
+    };
+
+    struct Buckets
+    {
+        explicit Buckets(size_t count) :
+            mask(count - 1),
+            heads(new std::atomic<const Entry*>[count])
+        {
+            for (size_t i = 0; i < count; ++i) heads[i] = nullptr;
+        }
+
+        size_t mask;
+        std::unique_ptr<std::atomic<const Entry*>[]> heads;
+    };
+
+    Entry* newEntry(size_t hash, const std::string* id, const Type* type)
+    {
+        entries.emplace_back(new Entry{ hash, id, type, nullptr });
+        return entries.back().get();
+    }
+
+    const Buckets* grow(const Buckets* old)
+    {
+        enum { InitialSize = 256 };
+        size_t count = old ? (old->mask + 1) * 2 : size_t(InitialSize);
+
+        std::unique_ptr<Buckets> table(new Buckets(count));
+
+        // The entries of the old table can't be relinked without breaking the
+        // chains that concurrent readers might be walking so they're copied.
+        for (size_t i = 0; old && i <= old->mask; ++i) {
+            const Entry* it = old->heads[i].load(std::memory_order_relaxed);
+            for (; it; it = it->next) {
+                auto& head = table->heads[it->hash & table->mask];
+
+                Entry* entry = newEntry(it->hash, it->id, it->type);
+                entry->next = head.load(std::memory_order_relaxed);
+                head.store(entry, std::memory_order_relaxed);
+            }
+        }
+
+        buckets.store(table.get(), std::memory_order_release);
+        tables.emplace_back(std::move(table));
+        return tables.back().get();
+    }
+
+    std::atomic<const Buckets*> buckets;
+    size_t size;
+
+    std::vector< std::unique_ptr<Buckets> > tables;
+    std::vector< std::unique_ptr<Entry> > entries;
+};
+
+} // namespace anonymous
+
+
 /******************************************************************************/
 /* REGISTRY STATE                                                             */
 /******************************************************************************/
 
 namespace {
 
+/** The lock is recursive because loading a type runs its loader which will in
+    turn look up all the types that it refers to.
+
+    A type is published to the lock-free table only once its loader has
+    completed. Until then, it's only reachable through the locked maps which
+    means that the only thread that can see a partially loaded type is the one
+    currently loading it; needed to reflect types that refer to themselves.
+ */
 struct RegistryState
 {
-    std::mutex lock;
-    std::unordered_map<std::string, const Type*> types;
-    std::unordered_map<std::string, std::string> aliases;
+    std::recursive_mutex lock;
+    std::unordered_map<Symbol, const Type*> types;
+    std::unordered_map<Symbol, Symbol> aliases;
     std::unordered_map<std::string, std::function<void(Type*)> > loaders;
+    std::unordered_set<const Type*> loading;
     Scope scopes;
-};
 
-RegistryState* registry_ = nullptr;
+    TypeTable published;
+};
 
+// Intentionally leaked so that the types remain valid until the very end.
 RegistryState& getRegistry()
 {
-    if (!registry_) registry_ = new RegistryState();
-    return *registry_;
+    static RegistryState* registry = new RegistryState();
+    return *registry;
 }
 
 } // namespace anonymous
@@ -51,21 +180,44 @@ globalScope()
 const Type*
 Registry::
 get(const std::string& id)
+{
+    bool loaded;
+    return lookup(id, loaded);
+}
+
+const Type*
+Registry::
+lookup(const std::string& id, bool& loaded)
 {
     auto& registry = getRegistry();
-    std::lock_guard<std::mutex>(registry.lock);
 
-    const std::string* pId = &id;
+    loaded = true;
+    if (const Type* type = registry.published.find(id)) return type;
+
+    std::lock_guard<std::recursive_mutex> guard(registry.lock);
+
+    // Ids that were never interned can't be in either map so there's no need
+    // to add them to the symbol table just to find out.
+    Symbol symbol = Symbol::find(id);
 
-    auto aliasIt = registry.aliases.find(*pId);
+    auto aliasIt = registry.aliases.find(symbol);
     if (aliasIt != registry.aliases.end())
-        pId = &aliasIt->second;
+        symbol = aliasIt->second;
 
-    auto typeIt = registry.types.find(*pId);
-    return typeIt != registry.types.end() ? typeIt->second : load(*pId);
+    const Type* type;
+    auto typeIt = registry.types.find(symbol);
+    type = typeIt != registry.types.end() ?
+        typeIt->second : load(symbol.empty() ? id : symbol.str());
+
+    // Loading the type interned its id so this doesn't grow the table.
+    loaded = !registry.loading.count(type);
+    if (loaded) registry.published.insert(Symbol(id), type);
+
+    return type;
 }
 
 
+// Must be called with the registry lock held.
 const Type*
 Registry::
 load(const std::string& id)
@@ -83,11 +235,16 @@ load(const std::string& id)
 
     Type* type;
     add(id, type = new Type(id));
+    registry.loading.insert(type);
 
     loader(type);
+    type->freeze();
+
+    registry.loading.erase(type);
     return type;
 }
 
+// Must be called with the registry lock held.
 void
 Registry::
 add(const std::string& id, const Type* type)
@@ -97,7 +254,7 @@ add(const std::string& id, const Type* type)
 
     auto& registry = getRegistry();
 
-    auto ret = registry.types.emplace(id, type);
+    auto ret = registry.types.emplace(Symbol(id), type);
     if (!ret.second) reflectError("<%s> already has a type", id);
 }
 
@@ -109,10 +266,14 @@ add(const std::string& id, std::function<void(Type*)> loader)
         reflectError("can't add loader for<%s>", id);
 
     auto& registry = getRegistry();
-    std::lock_guard<std::mutex>(registry.lock);
+    std::lock_guard<std::recursive_mutex> guard(registry.lock);
+
+    // Adding the same type more than once is a no-op whether or not it was
+    // already loaded. Template loaders rely on this to add themselves lazily.
+    Symbol symbol = Symbol::find(id);
+    if (!symbol.empty() && registry.types.count(symbol)) return;
+    if (!registry.loaders.emplace(id, std::move(loader)).second) return;
 
-    // If we already have a loader then too-bad.
-    registry.loaders.emplace(std::move(id), std::move(loader));
     registry.scopes.addType(id);
 }
 
@@ -124,9 +285,9 @@ alias(const std::string& id, const std::string& alias)
         reflectError("<%s> can't be aliased to <%s>", alias, id);
 
     auto& registry = getRegistry();
-    std::lock_guard<std::mutex>(registry.lock);
+    std::lock_guard<std::recursive_mutex> guard(registry.lock);
 
-    auto ret = registry.aliases.emplace(std::move(alias), std::move(id));
+    auto ret = registry.aliases.emplace(Symbol(alias), Symbol(id));
     if (!ret.second) {
         reflectError(
                 "<%s> can't be aliased to <%s> because it's already aliased to <%s>",
@@ -28,13 +28,30 @@ template<typename T, typename Enable = void> struct Loader;
 
 struct Registry
 {
+    /** Each instantiation caches its type in a static slot which turns every
+        lookup after the first into a single load instead of building the id
+        of the type (expensive for templates) and hashing it.
+
+        The slot is only filled once the type is fully loaded. Loaders
+        routinely look up the type they're loading (eg. copy constructors)
+        which also rules out the use of a function-local static initializer.
+     */
     template<typename T>
     static const Type* get()
     {
         typedef typename CleanType<T>::type CleanT;
 
+        static std::atomic<const Type*> slot;
+
+        const Type* type = slot.load(std::memory_order_acquire);
+        if (type) return type;
+
+        bool loaded;
         Reflect<CleanT>::loader();
-        return get(Reflect<CleanT>::id());
+        type = lookup(Reflect<CleanT>::id(), loaded);
+
+        if (loaded) slot.store(type, std::memory_order_release);
+        return type;
     }
 
     static const Type* get(const std::string& id);
@@ -61,6 +78,7 @@ struct Registry
     static Scope* globalScope();
 
 private:
+    static const Type* lookup(const std::string& id, bool& loaded);
     static void add(const std::string& id, const Type* type);
     static const Type* load(const std::string& id);
 };
@@ -289,7 +289,7 @@ addType(const std::string& name)
     if (typeIt != types_.end())
         reflectError("Type doesn't support inner classes yet");
 
-    auto fnIt = functions_.find(split.first);
+    auto fnIt = functions_.find(Symbol::find(split.first));
     if (fnIt != functions_.end())
         reflectError("<%s> conflicts with function in <%s>", name, id());
 
@@ -309,7 +309,7 @@ functions(bool includeScopes) const
     result.reserve(types_.size());
 
     for(auto& function : functions_)
-        result.push_back(function.first);
+        result.push_back(function.first.str());
 
     if (!includeScopes) return result;
 
@@ -333,7 +333,7 @@ hasFunction(const std::string& name) const
     if (!split.second.empty())
         return scope(split.second)->hasFunction(split.first);
 
-    auto it = functions_.find(split.first);
+    auto it = functions_.find(Symbol::find(split.first));
     return it != functions_.end();
 }
 
@@ -346,7 +346,7 @@ function(const std::string& name) const
     if (!split.second.empty())
         return scope(split.second)->function(split.first);
 
-    auto it = functions_.find(split.first);
+    auto it = functions_.find(Symbol::find(split.first));
     if (it == functions_.end())
         reflectError("<%s> has no function <%s>", id(), split.first);
 
@@ -362,7 +362,7 @@ addFunction(const std::string& name, Function fn)
     if (!split.second.empty())
         return scope(split.second)->addFunction(split.first, std::move(fn));
 
-    functions_[split.first].add(std::move(fn));
+    functions_[Symbol(split.first)].add(std::move(fn));
 }
 
 
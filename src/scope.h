@@ -66,7 +66,7 @@ private:
     std::unordered_map<std::string, Scope*> scopes_;
 
     std::unordered_map<std::string, const Type*> types_;
-    std::unordered_map<std::string, Overloads> functions_;
+    std::unordered_map<Symbol, Overloads> functions_;
 };
 
 } // reflect
@@ -0,0 +1,182 @@
+/* symbol.cpp                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   Symbol table.
+*/
+
+#include "reflect.h"
+
+namespace reflect {
+
+/******************************************************************************/
+/* SYMBOL TABLE                                                               */
+/******************************************************************************/
+
+namespace {
+
+/** Hash table of the interned strings which can be searched without holding
+    any locks.
+
+    Works just like the registry's TypeTable: nodes are only ever added by
+    pushing them at the head of their bucket's chain while holding the lock
+    and growing the table publishes a brand new bucket array. The strings live
+    in a deque which never moves them so that the nodes of every bucket array
+    point to the same copy.
+ */
+struct SymbolTable
+{
+    SymbolTable() : buckets(nullptr), size(0) {}
+
+    const std::string* find(const std::string& str, size_t hash) const
+    {
+        const Buckets* table = buckets.load(std::memory_order_acquire);
+        if (!table) return nullptr;
+
+        const Node* node =
+            table->heads[hash & table->mask].load(std::memory_order_acquire);
+
+        for (; node; node = node->next) {
+            if (node->hash == hash && *node->str == str) return node->str;
+        }
+
+        return nullptr;
+    }
+
+    // Must be called with the lock held.
+    const std::string* insert(const std::string& str, size_t hash)
+    {
+        if (const std::string* result = find(str, hash)) return result;
+
+        const Buckets* table = buckets.load(std::memory_order_relaxed);
+        if (!table || size >= table->mask + 1)
+            table = grow(table);
+
+        strings.push_back(str);
+        const std::string* result = &strings.back();
+
+        auto& head = table->heads[hash & table->mask];
+        Node* node = newNode(hash, result);
+        node->next = head.load(std::memory_order_relaxed);
+        head.store(node, std::memory_order_release);
+
+        size++;
+        return result;
+    }
+
+    std::mutex lock;
+
+private:
+
+    struct Node
+    {
+        size_t hash;
+        const std::string* str;
+        const Node* next;
+    };
+
+    struct Buckets
+    {
+        explicit Buckets(size_t count) :
+            mask(count - 1),
+            heads(new std::atomic<const Node*>[count])
+        {
+            for (size_t i = 0; i < count; ++i) heads[i] = nullptr;
+        }
+
+        size_t mask;
+        std::unique_ptr<std::atomic<const Node*>[]> heads;
+    };
+
+    Node* newNode(size_t hash, const std::string* str)
+    {
+        nodes.emplace_back(new Node{ hash, str, nullptr });
+        return nodes.back().get();
+    }
+
+    const Buckets* grow(const Buckets* old)
+    {
+        enum { InitialSize = 1024 };
+        size_t count = old ? (old->mask + 1) * 2 : size_t(InitialSize);
+
+        std::unique_ptr<Buckets> table(new Buckets(count));
+
+        // Readers might still be walking the old chains so they're copied.
+        for (size_t i = 0; old && i <= old->mask; ++i) {
+            const Node* it = old->heads[i].load(std::memory_order_relaxed);
+            for (; it; it = it->next) {
+                auto& head = table->heads[it->hash & table->mask];
+
+                Node* node = newNode(it->hash, it->str);
+                node->next = head.load(std::memory_order_relaxed);
+                head.store(node, std::memory_order_relaxed);
+            }
+        }
+
+        buckets.store(table.get(), std::memory_order_release);
+        tables.emplace_back(std::move(table));
+        return tables.back().get();
+    }
+
+    std::atomic<const Buckets*> buckets;
+    size_t size;
+
+    std::deque<std::string> strings;
+    std::vector< std::unique_ptr<Buckets> > tables;
+    std::vector< std::unique_ptr<Node> > nodes;
+};
+
+// Intentionally leaked so that symbols held by static objects remain valid
+// until the very end.
+SymbolTable& getSymbolTable()
+{
+    static SymbolTable* table = new SymbolTable();
+    return *table;
+}
+
+} // namespace anonymous
+
+
+/******************************************************************************/
+/* SYMBOL                                                                     */
+/******************************************************************************/
+
+const std::string*
+Symbol::
+emptyString()
+{
+    static const std::string* str = new std::string();
+    return str;
+}
+
+Symbol
+Symbol::
+find(const std::string& str)
+{
+    if (str.empty()) return Symbol();
+
+    size_t hash = std::hash<std::string>()(str);
+    const std::string* result = getSymbolTable().find(str, hash);
+    return result ? Symbol(result) : Symbol();
+}
+
+const std::string*
+Symbol::
+intern(const std::string& str)
+{
+    if (str.empty()) return emptyString();
+
+    auto& table = getSymbolTable();
+    size_t hash = std::hash<std::string>()(str);
+    if (const std::string* result = table.find(str, hash)) return result;
+
+    std::lock_guard<std::mutex> guard(table.lock);
+    return table.insert(str, hash);
+}
+
+std::ostream& operator<<(std::ostream& stream, Symbol symbol)
+{
+    return stream << symbol.str();
+}
+
+} // reflect
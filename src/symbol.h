@@ -0,0 +1,81 @@
+/* symbol.h                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   Interned strings used to key the reflection tables.
+
+   A symbol points to the unique copy of its string which means that comparing
+   and hashing symbols never needs to look at the characters. Creating a symbol
+   requires a lookup in a global table so symbols that are used over and over
+   should be created once and kept around:
+
+       static const Symbol field("field");
+
+   Symbols are never freed so they remain valid for the lifetime of the
+   program. Lookups of arbitrary strings (eg. user input) should go through
+   Symbol::find() instead which never adds to the table.
+*/
+
+#include "reflect.h"
+#pragma once
+
+namespace reflect {
+
+/******************************************************************************/
+/* SYMBOL                                                                     */
+/******************************************************************************/
+
+struct Symbol
+{
+    Symbol() : str_(emptyString()) {}
+    explicit Symbol(const char* str) : str_(intern(str)) {}
+    explicit Symbol(const std::string& str) : str_(intern(str)) {}
+
+    // Returns the empty symbol if str was never interned.
+    static Symbol find(const std::string& str);
+
+    const std::string& str() const { return *str_; }
+    const char* c_str() const { return str_->c_str(); }
+    bool empty() const { return str_->empty(); }
+
+    size_t hash() const { return std::hash<const std::string*>()(str_); }
+
+    bool operator==(Symbol other) const { return str_ == other.str_; }
+    bool operator!=(Symbol other) const { return str_ != other.str_; }
+
+    // Orders by address which is only meaningful for lookup tables and must
+    // never be used to order anything that gets printed.
+    bool operator<(Symbol other) const
+    {
+        return std::less<const std::string*>()(str_, other.str_);
+    }
+
+private:
+    explicit Symbol(const std::string* str) : str_(str) {}
+
+    static const std::string* emptyString();
+    static const std::string* intern(const std::string& str);
+
+    const std::string* str_;
+};
+
+std::ostream& operator<<(std::ostream& stream, Symbol symbol);
+
+inline const char* errorConvert(Symbol value) { return value.c_str(); }
+
+} // reflect
+
+
+/******************************************************************************/
+/* HASH                                                                       */
+/******************************************************************************/
+
+namespace std {
+
+template<>
+struct hash<reflect::Symbol>
+{
+    size_t operator() (reflect::Symbol symbol) const { return symbol.hash(); }
+};
+
+} // namespace std
@@ -0,0 +1,185 @@
+/* trait.cpp                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   Trait implementation.
+*/
+
+#include "reflect.h"
+
+namespace reflect {
+
+/******************************************************************************/
+/* TRAIT TABLE                                                                */
+/******************************************************************************/
+
+namespace {
+
+/** Traits are registered once by the DSL when a type is loaded but queried all
+    the time so the table is published as an immutable snapshot which readers
+    access without locking. Registering a trait copies the current snapshot
+    and publishes the copy. Older snapshots are kept around since readers
+    might still be using them which is fine given how few traits there are.
+ */
+struct TraitTable
+{
+    struct Snapshot
+    {
+        std::unordered_map<Symbol, size_t> ids;
+        std::vector<Symbol> names;
+    };
+
+    TraitTable()
+    {
+        std::unique_ptr<Snapshot> snapshot(new Snapshot);
+
+        // Must match the order of Trait::Id.
+        for (const char* name : {
+                    "primitive", "pointer", "list", "map", "string",
+                    "integer", "float", "bool", "field" })
+        {
+            snapshot->ids.emplace(Symbol(name), snapshot->names.size());
+            snapshot->names.emplace_back(name);
+        }
+
+        current = snapshot.get();
+        snapshots.emplace_back(std::move(snapshot));
+    }
+
+    const Snapshot* get() const
+    {
+        return current.load(std::memory_order_acquire);
+    }
+
+    std::atomic<const Snapshot*> current;
+
+    std::mutex lock;
+    std::vector< std::unique_ptr<Snapshot> > snapshots;
+};
+
+TraitTable& getTraitTable()
+{
+    static TraitTable* table = new TraitTable();
+    return *table;
+}
+
+} // namespace anonymous
+
+
+/******************************************************************************/
+/* TRAIT                                                                      */
+/******************************************************************************/
+
+Trait
+Trait::
+find(const std::string& name)
+{
+    Symbol symbol = Symbol::find(name);
+    if (symbol.empty()) return Trait(size_t(Unregistered));
+
+    const auto* snapshot = getTraitTable().get();
+
+    auto it = snapshot->ids.find(symbol);
+    if (it == snapshot->ids.end()) return Trait(size_t(Unregistered));
+
+    return Trait(it->second);
+}
+
+Trait
+Trait::
+add(const std::string& name)
+{
+    Trait trait = find(name);
+    if (trait.isRegistered()) return trait;
+
+    if (name.empty()) reflectError("can't add an empty trait");
+
+    auto& table = getTraitTable();
+    std::lock_guard<std::mutex> guard(table.lock);
+
+    const TraitTable::Snapshot* current = table.get();
+
+    Symbol symbol(name);
+    auto it = current->ids.find(symbol);
+    if (it != current->ids.end()) return Trait(it->second);
+
+    std::unique_ptr<TraitTable::Snapshot> next(
+            new TraitTable::Snapshot(*current));
+
+    size_t id = next->names.size();
+    next->ids.emplace(symbol, id);
+    next->names.push_back(symbol);
+
+    table.current.store(next.get(), std::memory_order_release);
+    table.snapshots.emplace_back(std::move(next));
+
+    return Trait(id);
+}
+
+Symbol
+Trait::
+name() const
+{
+    if (!isRegistered()) return Symbol();
+    return getTraitTable().get()->names[id_];
+}
+
+
+/******************************************************************************/
+/* TRAIT SET                                                                  */
+/******************************************************************************/
+
+bool
+TraitSet::
+empty() const
+{
+    if (bits) return false;
+
+    for (uint64_t word : overflow)
+        if (word) return false;
+
+    return true;
+}
+
+void
+TraitSet::
+insert(Trait trait)
+{
+    enum { Bits = 64 };
+
+    if (!trait.isRegistered()) reflectError("can't insert unregistered trait");
+
+    size_t id = trait.id();
+    if (id < Bits) {
+        bits |= uint64_t(1) << id;
+        return;
+    }
+
+    id -= Bits;
+    if (id / Bits >= overflow.size()) overflow.resize(id / Bits + 1, 0);
+    overflow[id / Bits] |= uint64_t(1) << (id % Bits);
+}
+
+std::vector<Trait>
+TraitSet::
+traits() const
+{
+    enum { Bits = 64 };
+
+    std::vector<Trait> result;
+
+    for (size_t i = 0; i < Bits; ++i) {
+        if (bits & (uint64_t(1) << i)) result.push_back(Trait(i));
+    }
+
+    for (size_t word = 0; word < overflow.size(); ++word) {
+        for (size_t i = 0; i < Bits; ++i) {
+            if (!(overflow[word] & (uint64_t(1) << i))) continue;
+            result.push_back(Trait(Bits + word * Bits + i));
+        }
+    }
+
+    return result;
+}
+
+} // reflect
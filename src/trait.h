@@ -0,0 +1,97 @@
+/* trait.h                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   Type and function traits.
+
+   Traits are mapped to dense integer ids which lets types keep their traits in
+   a bitset. The traits that the library itself relies on have fixed ids so
+   testing for them boils down to a single bit test. Any other trait is given
+   an id when a type is first tagged with it while queries only ever look up
+   the existing ids.
+*/
+
+#include "reflect.h"
+#pragma once
+
+namespace reflect {
+
+/******************************************************************************/
+/* TRAIT                                                                      */
+/******************************************************************************/
+
+struct Trait
+{
+    enum Id
+    {
+        Primitive,
+        Pointer,
+        List,
+        Map,
+        String,
+        Integer,
+        Float,
+        Bool,
+        Field,
+
+        WellKnown
+    };
+
+    Trait(Id id) : id_(id) {}
+
+    /** Returns the trait registered under name without registering it. A
+        trait that was never registered can't be part of any TraitSet so
+        testing for it always fails.
+     */
+    static Trait find(const std::string& name);
+
+    // Gives name an id if it doesn't already have one.
+    static Trait add(const std::string& name);
+
+    size_t id() const { return id_; }
+    bool isRegistered() const { return id_ != Unregistered; }
+    Symbol name() const;
+
+    bool operator==(Trait other) const { return id_ == other.id_; }
+    bool operator!=(Trait other) const { return id_ != other.id_; }
+
+private:
+    enum : size_t { Unregistered = size_t(-1) };
+
+    explicit Trait(size_t id) : id_(id) {}
+    friend struct TraitSet;
+
+    size_t id_;
+};
+
+
+/******************************************************************************/
+/* TRAIT SET                                                                  */
+/******************************************************************************/
+
+struct TraitSet
+{
+    TraitSet() : bits(0) {}
+
+    bool empty() const;
+    bool test(Trait trait) const
+    {
+        enum { Bits = 64 };
+
+        size_t id = trait.id();
+        if (id < Bits) return bits & (uint64_t(1) << id);
+
+        id -= Bits;
+        if (id / Bits >= overflow.size()) return false;
+        return overflow[id / Bits] & (uint64_t(1) << (id % Bits));
+    }
+
+    void insert(Trait trait);
+    std::vector<Trait> traits() const;
+
+private:
+    uint64_t bits;
+    std::vector<uint64_t> overflow;
+};
+
+} // reflect
@@ -18,59 +18,114 @@ namespace reflect {
 
 Type::
 Type(std::string id, const Type* parent) :
-    id_(std::move(id)), parent_(parent), pointee_(nullptr)
+    id_(std::move(id)), parent_(parent), pointee_(nullptr), frozen_(nullptr)
 {}
 
 void
 Type::
-addTrait(std::string trait)
+addTrait(Trait trait)
 {
-    traits_.emplace(std::move(trait));
+    traits_.insert(trait);
 }
 
-bool
+void
 Type::
-is(const std::string& trait) const
+addTrait(const std::string& trait)
+{
+    addTrait(Trait::add(trait));
+}
+
+namespace {
+
+std::vector<std::string> traitNames(const TraitSet& traits)
 {
-    return traits_.count(trait);
+    std::vector<std::string> result;
+    for (Trait trait : traits.traits()) result.push_back(trait.name().str());
+    return result;
 }
 
+} // namespace anonymous
+
 std::vector<std::string>
 Type::
 traits() const
 {
-    return { traits_.begin(), traits_.end() };
+    return traitNames(traits_);
 }
 
 void
 Type::
-addFunctionTrait(const std::string& fn, std::string trait)
+addFunctionTrait(Symbol fn, Trait trait)
 {
-    fnTraits_[fn].emplace(std::move(trait));
+    fnTraits_[fn].insert(trait);
+    thaw();
+}
+
+void
+Type::
+addFunctionTrait(const std::string& fn, Trait trait)
+{
+    addFunctionTrait(Symbol(fn), trait);
+}
+
+void
+Type::
+addFunctionTrait(const std::string& fn, const std::string& trait)
+{
+    addFunctionTrait(Symbol(fn), Trait::add(trait));
 }
 
 bool
 Type::
-functionIs(const std::string& fn, const std::string& trait) const
+functionIs(Symbol fn, Trait trait) const
 {
+    if (const Frozen* frozen = frozen_.load(std::memory_order_acquire)) {
+        const FlatFunction* flat = frozen->find(fn);
+        return flat && flat->traits && flat->traits->test(trait);
+    }
+
     auto it = fnTraits_.find(fn);
     if (it != fnTraits_.end())
-        return it->second.count(trait);
+        return it->second.test(trait);
 
     return parent_ ? parent_->functionIs(fn, trait) : false;
 }
 
+bool
+Type::
+functionIs(const std::string& fn, Trait trait) const
+{
+    Symbol symbol = Symbol::find(fn);
+    return !symbol.empty() && functionIs(symbol, trait);
+}
+
+bool
+Type::
+functionIs(const std::string& fn, const std::string& trait) const
+{
+    return functionIs(fn, Trait::find(trait));
+}
+
 std::vector<std::string>
 Type::
-functionTraits(const std::string& fn) const
+functionTraits(Symbol fn) const
 {
     auto it = fnTraits_.find(fn);
     if (it != fnTraits_.end())
-        return { it->second.begin(), it->second.end() };
+        return traitNames(it->second);
 
     return parent_ ? parent_->functionTraits(fn) : std::vector<std::string>();
 }
 
+std::vector<std::string>
+Type::
+functionTraits(const std::string& fn) const
+{
+    Symbol symbol = Symbol::find(fn);
+    if (symbol.empty()) return {};
+    return functionTraits(symbol);
+}
+
 
 bool
 Type::
@@ -141,24 +196,31 @@ isMovable() const
 
 void
 Type::
-functions(std::vector<std::string>& result, const std::string& trait) const
+functions(std::vector<std::string>& result, const Trait* trait) const
 {
     result.reserve(result.size() + fns_.size());
 
     for (const auto& f : fns_) {
-        if (!trait.empty() && !functionIs(f.first, trait)) continue;
-        result.push_back(f.first);
+        if (trait && !functionIs(f.first, *trait)) continue;
+        result.push_back(f.first.str());
     }
 
     if (parent_) parent_->functions(result, trait);
 }
 
+const std::vector<std::string>&
+Type::
+functions() const
+{
+    return frozen()->names;
+}
+
 std::vector<std::string>
 Type::
-functions(const std::string& trait) const
+functions(Trait trait) const
 {
     std::vector<std::string> result;
-    functions(result, trait);
+    functions(result, &trait);
 
     std::sort(result.begin(), result.end());
     result.erase(std::unique(result.begin(), result.end()), result.end());
@@ -166,18 +228,45 @@ functions(const std::string& trait) const
     return result;
 }
 
+std::vector<std::string>
+Type::
+functions(const std::string& trait) const
+{
+    return functions(Trait::find(trait));
+}
+
 bool
 Type::
-hasFunction(const std::string& fn) const
+hasFunction(Symbol fn) const
 {
+    if (const Frozen* frozen = frozen_.load(std::memory_order_acquire)) {
+        const FlatFunction* flat = frozen->find(fn);
+        return flat && flat->fns;
+    }
+
     if (fns_.find(fn) != fns_.end()) return true;
     return parent_ ? parent_->hasFunction(fn) : false;
 }
 
+bool
+Type::
+hasFunction(const std::string& fn) const
+{
+    Symbol symbol = Symbol::find(fn);
+    return !symbol.empty() && hasFunction(symbol);
+}
+
 const Overloads&
 Type::
-function(const std::string& fn) const
+function(Symbol fn) const
 {
+    if (const Frozen* frozen = frozen_.load(std::memory_order_acquire)) {
+        const FlatFunction* flat = frozen->find(fn);
+        if (!flat || !flat->fns)
+            reflectError("<%s> doesn't have a function <%s>", id_, fn);
+        return *flat->fns;
+    }
+
     auto it = fns_.find(fn);
     if (it != fns_.end()) return it->second;
 
@@ -187,23 +276,41 @@ function(const std::string& fn) const
     return parent_->function(fn);
 }
 
-std::vector<std::string>
+const Overloads&
+Type::
+function(const std::string& fn) const
+{
+    Symbol symbol = Symbol::find(fn);
+    if (symbol.empty())
+        reflectError("<%s> doesn't have a function <%s>", id_, fn);
+
+    return function(symbol);
+}
+
+const std::vector<std::string>&
 Type::
 fields() const
 {
-    return functions("field");
+    return frozen()->fields;
+}
+
+bool
+Type::
+hasField(Symbol field) const
+{
+    return functionIs(field, Trait::Field);
 }
 
 bool
 Type::
 hasField(const std::string& field) const
 {
-    return functionIs(field, "field");
+    return functionIs(field, Trait::Field);
 }
 
 const Overloads&
 Type::
-field(const std::string& field) const
+field(Symbol field) const
 {
     if (!hasField(field))
         reflectError("<%s> doesn't have a field <%s>", id_, field);
@@ -211,6 +318,24 @@ field(const std::string& field) const
     return function(field);
 }
 
+const Overloads&
+Type::
+field(const std::string& field) const
+{
+    Symbol symbol = Symbol::find(field);
+    if (symbol.empty())
+        reflectError("<%s> doesn't have a field <%s>", id_, field);
+
+    return this->field(symbol);
+}
+
+const Type*
+Type::
+fieldType(Symbol field) const
+{
+    return this->field(field).fieldType();
+}
+
 const Type*
 Type::
 fieldType(const std::string& field) const
@@ -218,14 +343,45 @@ fieldType(const std::string& field) const
     return this->field(field).fieldType();
 }
 
+const std::vector<FieldDescriptor>&
+Type::
+fieldDescriptors() const
+{
+    return frozen()->fieldDescs;
+}
 
-bool
+const FieldDescriptor*
+Type::
+fieldDescriptor(Symbol field) const
+{
+    const FlatFunction* flat = frozen()->find(field);
+    return flat ? flat->field : nullptr;
+}
+
+const FieldDescriptor*
+Type::
+fieldDescriptor(const std::string& field) const
+{
+    Symbol symbol = Symbol::find(field);
+    return symbol.empty() ? nullptr : fieldDescriptor(symbol);
+}
+
+void
+Type::
+setFieldOffset(Symbol field, size_t offset)
+{
+    fieldOffsets_[field] = offset;
+    thaw();
+}
+
+void
 Type::
-isPointer() const
+setFieldOffset(const std::string& field, size_t offset)
 {
-    return is("pointer");
+    setFieldOffset(Symbol(field), offset);
 }
 
+
 std::string
 Type::
 pointer() const
@@ -248,17 +404,18 @@ setPointer(std::string pointer, const Type* pointee)
 {
     if (isPointer()) reflectError("<%s> is already a pointer", id());
 
-    addTrait("pointer");
+    addTrait(Trait::Pointer);
     pointer_ = std::move(pointer);
     pointee_ = pointee;
 }
 
 void
 Type::
-add(const std::string& name, Function&& fn)
+add(Symbol name, Function&& fn)
 {
     bool isField = fn.isGetter() || fn.isSetter();
     fns_[name].add(std::move(fn));
+    thaw();
 
     // let's add to fields if it passes the constructor and operator filter.
 
@@ -266,24 +423,165 @@ add(const std::string& name, Function&& fn)
     if (name == id_) return;
 
     static const std::string op = "operator";
-    size_t pos = name.find(op);
+    const std::string& str = name.str();
+    size_t pos = str.find(op);
 
-    if (pos == 0 && name.size() > op.size()) {
-        char c = name[op.size()];
+    if (pos == 0 && str.size() > op.size()) {
+        char c = str[op.size()];
         if (c != '_' && !std::isalpha(c)) return;
     }
 
-    addFunctionTrait(name, "field");
+    addFunctionTrait(name, Trait::Field);
+}
+
+void
+Type::
+add(const std::string& name, Function&& fn)
+{
+    add(Symbol(name), std::move(fn));
+}
+
+
+
+/******************************************************************************/
+/* FREEZE                                                                     */
+/******************************************************************************/
+
+namespace {
+
+FieldDescriptor makeFieldDescriptor(
+        Symbol name, const Overloads& fns, size_t offset)
+{
+    FieldDescriptor field = { name, fns.fieldType(), nullptr, nullptr, offset };
+
+    for (size_t i = 0; i < fns.size(); ++i) {
+        if (!field.getter && fns[i].isGetter()) field.getter = &fns[i];
+        if (!field.setter && fns[i].isSetter()) field.setter = &fns[i];
+    }
+
+    return field;
 }
 
+} // namespace anonymous
+
+void
+Type::
+freeze()
+{
+    std::lock_guard<std::mutex> guard(freezeLock_);
+    build();
+}
+
+auto
+Type::
+frozen() const -> const Frozen*
+{
+    if (const Frozen* frozen = frozen_.load(std::memory_order_acquire))
+        return frozen;
+
+    std::lock_guard<std::mutex> guard(freezeLock_);
+
+    if (const Frozen* frozen = frozen_.load(std::memory_order_relaxed))
+        return frozen;
+
+    return build();
+}
+
+// Must be called with freezeLock_ held.
+auto
+Type::
+build() const -> const Frozen*
+{
+    std::unordered_map<Symbol, FlatFunction> flat;
+    std::unordered_map<Symbol, size_t> offsets;
+
+    // Walking from the child to its parents means that the first entry found
+    // for a name is the one that shadows the others.
+    for (const Type* type = this; type; type = type->parent_) {
+        for (const auto& fn : type->fns_) {
+            FlatFunction& entry = flat[fn.first];
+            entry.name = fn.first;
+            if (entry.fns) continue;
+
+            entry.fns = &fn.second;
+
+            auto it = type->fieldOffsets_.find(fn.first);
+            if (it != type->fieldOffsets_.end()) offsets[fn.first] = it->second;
+        }
+
+        for (const auto& traits : type->fnTraits_) {
+            FlatFunction& entry = flat[traits.first];
+            entry.name = traits.first;
+            if (!entry.traits) entry.traits = &traits.second;
+        }
+    }
+
+    std::unique_ptr<Frozen> frozen(new Frozen);
+
+    frozen->fns.reserve(flat.size());
+    for (const auto& entry : flat) {
+        frozen->fns.push_back(entry.second);
+        if (!entry.second.fns) continue;
+
+        frozen->names.push_back(entry.first.str());
+
+        const TraitSet* traits = entry.second.traits;
+        if (traits && traits->test(Trait::Field))
+            frozen->fields.push_back(entry.first.str());
+    }
+
+    std::sort(frozen->fns.begin(), frozen->fns.end());
+    std::sort(frozen->names.begin(), frozen->names.end());
+    std::sort(frozen->fields.begin(), frozen->fields.end());
+
+    // Reserved upfront so that the flat entries can point into it.
+    frozen->fieldDescs.reserve(frozen->fields.size());
+    for (const auto& name : frozen->fields) {
+        Symbol symbol = Symbol::find(name);
+        auto& entry = const_cast<FlatFunction&>(*frozen->find(symbol));
+
+        auto it = offsets.find(symbol);
+        size_t offset = it != offsets.end() ? it->second : size_t(-1);
+
+        frozen->fieldDescs.push_back(
+                makeFieldDescriptor(symbol, *entry.fns, offset));
+        entry.field = &frozen->fieldDescs.back();
+    }
+
+    frozen_.store(frozen.get(), std::memory_order_release);
+    snapshots_.emplace_back(std::move(frozen));
+    return snapshots_.back().get();
+}
+
+/** The flattened tables are left alive since anything could still be holding
+    on to them; most notably the field descriptors used by the json decoders
+    and encoders.
+ */
+void
+Type::
+thaw()
+{
+    frozen_.store(nullptr, std::memory_order_release);
+}
+
+auto
+Type::
+Frozen::
+find(Symbol fn) const -> const FlatFunction*
+{
+    FlatFunction key = { fn, nullptr, nullptr, nullptr };
+    auto it = std::lower_bound(fns.begin(), fns.end(), key);
+
+    if (it == fns.end() || it->name != fn) return nullptr;
+    return &*it;
+}
 
 namespace {
 
-void printTraits(
-        std::stringstream& ss, const std::unordered_set<std::string>& traits)
+void printTraits(std::stringstream& ss, const TraitSet& traits)
 {
     ss<< "traits: [ ";
-    for (auto& trait : traits) ss << trait << " ";
+    for (Trait trait : traits.traits()) ss << trait.name() << " ";
     ss << "]\n";
 }
 
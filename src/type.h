@@ -10,6 +10,30 @@
 
 namespace reflect {
 
+/******************************************************************************/
+/* FIELD DESCRIPTOR                                                           */
+/******************************************************************************/
+
+/** Pre-resolved description of a field which can be used to walk the fields
+    of an object without going through name lookups and overload resolution.
+
+    The offset is only available for fields reflected from a non-const data
+    member (eg. reflectField on a member variable) in which case the field can
+    be accessed in place without calling any function. See Value::field().
+ */
+struct FieldDescriptor
+{
+    Symbol name;
+    const Type* type;
+
+    const Function* getter; // T(const Obj&) or null
+    const Function* setter; // void(Obj&, T) or null
+
+    size_t offset;
+    bool hasOffset() const { return offset != size_t(-1); }
+};
+
+
 /******************************************************************************/
 /* TYPE                                                                       */
 /******************************************************************************/
@@ -23,32 +47,84 @@ struct Type
     Type& operator=(Type&&) = delete;
     Type& operator=(const Type&) = delete;
 
-    const std::string& id() const { return id_; }
+    const std::string& id() const { return id_.str(); }
     const Type* parent() const { return parent_; }
-    void parent(const Type* parent) { parent_ = parent; }
+    void parent(const Type* parent) { parent_ = parent; thaw(); }
+
+    /** Flattens the function tables of the type and all of its parents into a
+        single sorted array which turns lookups into a binary search instead of
+        a hash lookup per level of the hierarchy. The list of functions and
+        fields are also computed once and for all.
+
+        Called by the registry once the loader of the type has completed.
+        Modifying the type afterwards will discard the flattened tables but
+        children that were already frozen will not pick up the changes. The
+        accessors that need the flattened tables freeze the type again on
+        demand.
+
+        The flattened tables are never freed so references to them, and to
+        the field descriptors in particular, remain valid even once the type
+        is modified.
+     */
+    void freeze();
+    bool isFrozen() const { return frozen_.load(std::memory_order_acquire); }
+
+    /** Functions and fields can be looked up either by Symbol or by string.
+        The string overloads go through Symbol::find() so looking up a name
+        that was never registered doesn't grow the symbol table.
+     */
+
+    template<typename Fn>
+    void add(Symbol name, Fn&& rawFn);
+    void add(Symbol name, Function&& fn);
 
     template<typename Fn>
     void add(const std::string& name, Fn&& rawFn);
     void add(const std::string& name, Function&& fn);
 
-    std::vector<std::string> functions(const std::string& trait = "") const;
+    const std::vector<std::string>& functions() const;
+    std::vector<std::string> functions(Trait trait) const;
+    std::vector<std::string> functions(const std::string& trait) const;
+    bool hasFunction(Symbol fn) const;
     bool hasFunction(const std::string& fn) const;
+    const Overloads& function(Symbol fn) const;
     const Overloads& function(const std::string& fn) const;
 
-    std::vector<std::string> fields() const;
+    const std::vector<std::string>& fields() const;
+    bool hasField(Symbol field) const;
     bool hasField(const std::string& field) const;
+    const Overloads& field(Symbol field) const;
     const Overloads& field(const std::string& field) const;
+    const Type* fieldType(Symbol field) const;
     const Type* fieldType(const std::string& field) const;
 
-    void addTrait(std::string trait);
-    bool is(const std::string& trait) const;
+    // Freezes the type if needed. See freeze().
+    const std::vector<FieldDescriptor>& fieldDescriptors() const;
+    const FieldDescriptor* fieldDescriptor(Symbol field) const;
+    const FieldDescriptor* fieldDescriptor(const std::string& field) const;
+
+    void setFieldOffset(Symbol field, size_t offset);
+    void setFieldOffset(const std::string& field, size_t offset);
+
+    /** Traits named by string are registered when added but only looked up
+        when queried. See Trait::find().
+     */
+    void addTrait(Trait trait);
+    void addTrait(const std::string& trait);
+    bool is(Trait trait) const { return traits_.test(trait); }
+    bool is(const std::string& trait) const { return is(Trait::find(trait)); }
     std::vector<std::string> traits() const;
 
-    void addFunctionTrait(const std::string& fn, std::string trait);
+    void addFunctionTrait(Symbol fn, Trait trait);
+    void addFunctionTrait(const std::string& fn, Trait trait);
+    void addFunctionTrait(const std::string& fn, const std::string& trait);
+    bool functionIs(Symbol fn, Trait trait) const;
+    bool functionIs(const std::string& fn, Trait trait) const;
     bool functionIs(const std::string& fn, const std::string& trait) const;
+    std::vector<std::string> functionTraits(Symbol fn) const;
     std::vector<std::string> functionTraits(const std::string& fn) const;
 
-    bool isPointer() const;
+    bool isPointer() const { return is(Trait::Pointer); }
     std::string pointer() const;
     const Type* pointee() const;
     void setPointer(std::string pointer, const Type* pointee);
@@ -78,25 +154,67 @@ struct Type
     template<typename... Args>
     Value alloc(Args&&... args) const;
 
+    template<typename Ret, typename... Args>
+    Ret call(Symbol fn, Args&&... args) const;
+
     template<typename Ret, typename... Args>
     Ret call(const std::string& fn, Args&&... args) const;
 
+    template<typename Fn>
+    BoundFunction<Fn> bind(Symbol fn) const;
+
+    template<typename Fn>
+    BoundFunction<Fn> bind(const std::string& fn) const;
+
     std::string print(size_t indent = 0) const;
 
 private:
 
-    void functions(std::vector<std::string>& result, const std::string& trait) const;
+    void functions(std::vector<std::string>& result, const Trait* trait) const;
+
+    struct FlatFunction
+    {
+        Symbol name;
+        const Overloads* fns;
+        const TraitSet* traits;
+        const FieldDescriptor* field;
 
-    std::string id_;
+        bool operator<(const FlatFunction& other) const
+        {
+            return name < other.name;
+        }
+    };
+
+    struct Frozen
+    {
+        std::vector<FlatFunction> fns;
+        std::vector<std::string> names;
+        std::vector<std::string> fields;
+        std::vector<FieldDescriptor> fieldDescs;
+
+        const FlatFunction* find(Symbol fn) const;
+    };
+
+    const Frozen* frozen() const;
+    const Frozen* build() const;
+    void thaw();
+
+    Symbol id_;
     const Type* parent_;
 
     std::string pointer_;
     const Type* pointee_;
 
-    std::unordered_map<std::string, Overloads> fns_;
+    std::unordered_map<Symbol, Overloads> fns_;
+
+    TraitSet traits_;
+    std::unordered_map<Symbol, TraitSet> fnTraits_;
+
+    std::unordered_map<Symbol, size_t> fieldOffsets_;
 
-    std::unordered_set<std::string> traits_;
-    std::unordered_map<std::string, std::unordered_set<std::string> > fnTraits_;
+    mutable std::atomic<const Frozen*> frozen_;
+    mutable std::mutex freezeLock_;
+    mutable std::vector< std::unique_ptr<Frozen> > snapshots_;
 };
 
 
@@ -19,7 +19,7 @@ Value
 Type::
 construct(Args&&... args) const
 {
-    return call<Value>(id(), std::forward<Args>(args)...);
+    return call<Value>(id_, std::forward<Args>(args)...);
 }
 
 template<typename... Args>
@@ -27,7 +27,16 @@ Value
 Type::
 alloc(Args&&... args) const
 {
-    return call<Value>("new", std::forward<Args>(args)...);
+    static const Symbol fn("new");
+    return call<Value>(fn, std::forward<Args>(args)...);
+}
+
+template<typename Ret, typename... Args>
+Ret
+Type::
+call(Symbol fn, Args&&... args) const
+{
+    return function(fn).call<Ret>(std::forward<Args>(args)...);
 }
 
 template<typename Ret, typename... Args>
@@ -38,13 +47,37 @@ call(const std::string& fn, Args&&... args) const
     return function(fn).call<Ret>(std::forward<Args>(args)...);
 }
 
+template<typename Fn>
+BoundFunction<Fn>
+Type::
+bind(Symbol fn) const
+{
+    return function(fn).bind<Fn>();
+}
+
+template<typename Fn>
+BoundFunction<Fn>
+Type::
+bind(const std::string& fn) const
+{
+    return function(fn).bind<Fn>();
+}
+
+
+template<typename Fn>
+void
+Type::
+add(Symbol name, Fn&& rawFn)
+{
+    add(name, Function(name.str(), std::move(rawFn)));
+}
 
 template<typename Fn>
 void
 Type::
 add(const std::string& name, Fn&& rawFn)
 {
-    add(name, Function(name, std::move(rawFn)));
+    add(Symbol(name), Function(name, std::move(rawFn)));
 }
 
 } // namespace reflect
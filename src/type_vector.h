@@ -44,4 +44,30 @@ struct RepeatType
 };
 
 
+/******************************************************************************/
+/* INDEXES                                                                    */
+/******************************************************************************/
+
+template<size_t... I> struct Indexes {};
+
+namespace details {
+
+template<size_t N, size_t... I>
+struct MakeIndexes : MakeIndexes<N-1, N-1, I...> {};
+
+template<size_t... I>
+struct MakeIndexes<0, I...>
+{
+    typedef Indexes<I...> type;
+};
+
+} // namespace details
+
+template<size_t N>
+struct MakeIndexes
+{
+    typedef typename details::MakeIndexes<N>::type type;
+};
+
+
 } // reflect
@@ -41,6 +41,7 @@ struct Reflect<T*>
         reflectCustom(operator*) (T* const& value) -> const T& {
             return *value;
         };
+        reflectCustom(operator bool()) (T* const& value) { return !!value; };
     }
 };
 
@@ -21,10 +21,25 @@ std::string verrorFormat(const char* fmt, ...)
     std::va_list args;
     va_start(args, fmt);
 
-    char buf[1024];
-    int n = std::vsnprintf(buf, sizeof(buf) - 1, fmt, args);
+    std::va_list retry;
+    va_copy(retry, args);
 
-    return std::string(buf, n);
+    char buf[1024];
+    int n = std::vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+
+    // Messages that embed large chunks of input don't fit on the stack.
+    std::string msg;
+    if (n < 0) msg = fmt;
+    else if (size_t(n) < sizeof(buf)) msg.assign(buf, n);
+    else {
+        msg.resize(n + 1);
+        std::vsnprintf(&msg[0], n + 1, fmt, retry);
+        msg.resize(n);
+    }
+
+    va_end(retry);
+    return msg;
 }
 
 
@@ -10,6 +10,25 @@
 namespace reflect {
 namespace config {
 
+/******************************************************************************/
+/* UTILS                                                                      */
+/******************************************************************************/
+
+namespace {
+
+bool isPrefix(const Path& prefix, const Path& path)
+{
+    if (path.size() < prefix.size()) return false;
+
+    for (size_t i = 0; i < prefix.size(); ++i)
+        if (!prefix.sameComponent(i, path)) return false;
+
+    return true;
+}
+
+} // namespace anonymous
+
+
 /******************************************************************************/
 /* CONFIG                                                                     */
 /******************************************************************************/
@@ -37,6 +56,38 @@ operator[] (const Path& path) const
     return config::get(it->second, path, 1);
 }
 
+CompiledPath
+Config::
+compile(const Path& path) const
+{
+    auto it = keys_.find(path.front());
+    if (it == keys_.end())
+        reflectError("path <%s> doesn't exist", path.toString());
+
+    return CompiledPath(it->second.type(), path, 1);
+}
+
+bool
+Config::
+count(const CompiledPath& path) const
+{
+    auto it = keys_.find(path.path().front());
+    if (it == keys_.end()) return false;
+
+    return path.has(it->second);
+}
+
+Value
+Config::
+operator[] (const CompiledPath& path) const
+{
+    auto it = keys_.find(path.path().front());
+    if (it == keys_.end())
+        reflectError("path <%s> doesn't exist", path.path().toString());
+
+    return path.get(it->second);
+}
+
 std::vector<std::string>
 Config::
 keys() const
@@ -50,10 +101,14 @@ void
 Config::
 propagate(const Path& path, Value value)
 {
-    auto sublinks = links.get(path)->subtree();
+    // Most paths have no pending links so look before allocating anything.
+    const Node* node = links.find(path);
+    if (!node || node->empty()) return;
+
+    auto sublinks = node->subtree();
 
     for (auto& sub : sublinks)
-        set(sub.second, value);
+        assign(sub.second, value);
 
     links.erase(path);
 }
@@ -61,6 +116,14 @@ propagate(const Path& path, Value value)
 void
 Config::
 set(const Path& path, Value value)
+{
+    unlink(path);
+    assign(path, value);
+}
+
+void
+Config::
+assign(const Path& path, Value value)
 {
     auto it = keys_.find(path.front());
 
@@ -92,10 +155,27 @@ relink(const Path& link, const Path& target)
     links.erase(link);
 }
 
+// Links are overwritten along with everything underneath them. Since paths
+// are ordered lexicographically, those are all stored right after the path.
+void
+Config::
+unlink(const Path& path)
+{
+    auto first = linkTargets_.lower_bound(path);
+
+    auto last = first;
+    while (last != linkTargets_.end() && isPrefix(path, last->first)) ++last;
+
+    linkTargets_.erase(first, last);
+}
+
 void
 Config::
 link(const Path& link, const Path& target)
 {
+    unlink(link);
+    linkTargets_[link] = target;
+
     auto it = keys_.find(target.front());
     if (it == keys_.end()) {
         links.add(link, target);
@@ -106,7 +186,101 @@ link(const Path& link, const Path& target)
     Value value = it->second;
     if (target.size() > 1)
         value = config::get(value, target, 1);
-    set(link, value);
+    assign(link, value);
+}
+
+// Builds the dependency graph of the links and sorts them in topological
+// order which is linear in the number of links, give or take the map lookups
+// used to find the links that overlap a path. Returns false and a link that
+// is part of a cycle if the links can't be ordered.
+bool
+Config::
+orderLinks(const Links& batch, std::vector<size_t>& order, size_t& cycle) const
+{
+    // Later links to the same path replace the earlier ones.
+    std::map<Path, size_t> index;
+    for (size_t i = 0; i < batch.size(); ++i) index[batch[i].first] = i;
+
+    std::vector< std::vector<size_t> > dependents(batch.size());
+    std::vector<size_t> pending(batch.size(), 0);
+
+    auto depend = [&] (size_t link, size_t on) {
+        dependents[on].push_back(link);
+        pending[link]++;
+    };
+
+    // Links at or above the path.
+    auto dependAbove = [&] (size_t link, Path path, bool inclusive) {
+        if (!inclusive && !path.empty()) path = path.popBack();
+
+        for (; !path.empty(); path = path.popBack()) {
+            auto it = index.find(path);
+            if (it != index.end()) depend(link, it->second);
+        }
+    };
+
+    // Pointers are shared by the link so their content doesn't have to be
+    // resolved beforehand. Targets under another link can't be checked yet
+    // and are assumed to be copied.
+    auto isShared = [&] (const Path& target) {
+        auto it = keys_.find(target.front());
+        if (it == keys_.end()) return false;
+
+        Value value = it->second;
+        if (target.size() > 1) {
+            if (!has(value, target, 1)) return false;
+            value = config::get(value, target, 1);
+        }
+
+        return value.type()->isPointer();
+    };
+
+    for (const auto& entry : index) {
+        size_t i = entry.second;
+        const Path& target = batch[i].second;
+
+        dependAbove(i, batch[i].first, false);
+        dependAbove(i, target, true);
+
+        if (isShared(target)) continue;
+
+        auto it = index.upper_bound(target);
+        for (; it != index.end() && isPrefix(target, it->first); ++it)
+            depend(i, it->second);
+    }
+
+    order.clear();
+    order.reserve(index.size());
+
+    for (const auto& entry : index)
+        if (!pending[entry.second]) order.push_back(entry.second);
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        for (size_t link : dependents[order[i]])
+            if (!--pending[link]) order.push_back(link);
+    }
+
+    if (order.size() != index.size()) {
+
+        // Every link left over waits on at least one other left over link so
+        // walking back through them long enough is bound to end up in a cycle.
+        std::vector<size_t> waitsOn(batch.size(), batch.size());
+        for (size_t on = 0; on < batch.size(); ++on) {
+            if (!pending[on]) continue;
+            for (size_t link : dependents[on]) waitsOn[link] = on;
+        }
+
+        size_t link = order.size();
+        for (const auto& entry : index)
+            if (pending[entry.second]) link = entry.second;
+
+        for (size_t i = 0; i < index.size(); ++i) link = waitsOn[link];
+
+        cycle = link;
+        return false;
+    }
+
+    return true;
 }
 
 
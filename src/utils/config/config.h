@@ -23,17 +23,47 @@ struct Config
     T get(const Path& path) const;
     Value operator[] (const Path& path) const;
 
+    /** Binds the path to the type of the value currently stored under its
+        first component so that it can be walked repeatedly without resolving
+        every component on each access.
+     */
+    CompiledPath compile(const Path& path) const;
+    bool count(const CompiledPath& path) const;
+    Value operator[] (const CompiledPath& path) const;
+
     std::vector<std::string> keys() const;
 
     void set(const Path& path, Value value);
     void link(const Path& link, const Path& target);
 
+    /** Pairs of link and target. */
+    typedef std::vector< std::pair<Path, Path> > Links;
+
+    /** Resolves a batch of links once every value they may refer to has been
+        set. Links are ordered so that each one comes after the links at or
+        above its own path and its target and, unless the target holds a
+        pointer which is shared rather than copied, the links underneath its
+        target. Cycles are reported before any of the links are applied.
+     */
+    void link(const Links& links);
+
+    // Every link made so far, resolved or not, indexed by the link's path.
+    const std::map<Path, Path>& linkTargets() const { return linkTargets_; }
+
 private:
+    bool orderLinks(
+            const Links& batch,
+            std::vector<size_t>& order,
+            size_t& cycle) const;
+
+    void assign(const Path& path, Value value);
+    void unlink(const Path& path);
     void propagate(const Path& path, Value value);
     void relink(const Path& link, const Path& target);
 
     Node links;
     std::unordered_map<std::string, Value> keys_;
+    std::map<Path, Path> linkTargets_;
 };
 
 
@@ -27,5 +27,22 @@ get(const Path& path) const
     return cast<T>(value);
 }
 
+// Raised from the header so that cycles honour the caller's choice of
+// REFLECT_USE_EXCEPTIONS.
+inline void
+Config::
+link(const Links& batch)
+{
+    size_t cycle;
+    std::vector<size_t> order;
+
+    if (!orderLinks(batch, order, cycle)) {
+        reflectError("link cycle through <%s> -> <%s>",
+                batch[cycle].first.toString(), batch[cycle].second.toString());
+    }
+
+    for (size_t i : order) link(batch[i].first, batch[i].second);
+}
+
 } // namespace config
 } // namespace reflect
@@ -8,6 +8,8 @@
 #pragma once
 
 #include <set>
+#include <map>
+#include <memory>
 #include <vector>
 #include <unordered_map>
 
@@ -7,8 +7,13 @@
 
 #include "includes.h"
 #include "utils/json/token.h"
+#include "utils/json/file.h"
 
 #include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <exception>
 
 namespace reflect {
 namespace config {
@@ -40,37 +45,73 @@ parseKey(const std::string& str)
     return std::make_tuple(isLink, key, str.substr(next));
 }
 
+// The tokenizer records malformed input in the context instead of raising an
+// error so we raise it ourselves.
+Token readToken(BufferContext& json)
+{
+    Token token = nextToken(json);
+    if (json.failed()) reflectError("%s", json.error().print());
+    return token;
+}
+
 
 /******************************************************************************/
 /* LOAD                                                                       */
 /******************************************************************************/
 
-void load(Config& cfg, const Path& path, std::istream& json);
-void load(Config& cfg, const Path& path, const Token& token, std::istream& json);
+// Values are set as they're read but links are collected and resolved once
+// the whole document has been read so that they can refer to anything in it.
+//
+// Loaders that aren't attached to a config build a single root object instead
+// which is handed over to a config once it's complete.
+struct Loader
+{
+    Loader() : cfg(nullptr) {}
+    explicit Loader(Config& cfg) : cfg(&cfg) {}
+
+    void set(const Path& path, Value value)
+    {
+        if (cfg) cfg->set(path, value);
+        else if (path.size() == 1) root = value;
+        else config::set(root, path, 1, value);
+    }
+
+    void link(const Path& link, const Path& target)
+    {
+        links.emplace_back(link, target);
+    }
 
-void loadLink(Config& cfg, const Path& path, std::istream& json);
-void loadLink(Config& cfg, const Path& path, const Token& token, std::istream& json);
+    Config* cfg;
+    Value root;
+    Config::Links links;
+};
 
+void load(Loader& cfg, const Path& path, BufferContext& json);
+void load(Loader& cfg, const Path& path, const Token& token, BufferContext& json);
 
-void loadNull(Config&, const Path&) {}
+void loadLink(Loader& cfg, const Path& path, BufferContext& json);
+void loadLink(Loader& cfg, const Path& path, const Token& token, BufferContext& json);
 
-void loadBool(Config& cfg, const Path& path, Token token)
+
+void loadNull(Loader&, const Path&) {}
+
+void loadBool(Loader& cfg, const Path& path, Token token)
 {
     cfg.set(path, Value(token.boolValue()));
 }
 
-void loadNumber(Config& cfg, const Path& path, Token token)
+void loadNumber(Loader& cfg, const Path& path, Token token)
 {
     cfg.set(path, Value(token.floatValue()));
 }
 
-void loadString(Config& cfg, const Path& path, Token token)
+void loadString(Loader& cfg, const Path& path, Token token)
 {
     cfg.set(path, Value(token.stringValue()));
 }
 
 
-void initArray(Config& cfg, const Path& path, const Token& token)
+void initArray(Loader& cfg, const Path& path, const Token& token)
 {
     const Type* tVector = nullptr;
 
@@ -86,9 +127,9 @@ void initArray(Config& cfg, const Path& path, const Token& token)
     cfg.set(path, tVector->construct());
 }
 
-void loadArray(Config& cfg, const Path& path, std::istream& json)
+void loadArray(Loader& cfg, const Path& path, BufferContext& json)
 {
-    Token token = nextToken(json);
+    Token token = readToken(json);
     if (token.type() == Token::ArrayEnd) return;
 
     if (path.size() == 1) initArray(cfg, path, token);
@@ -97,9 +138,9 @@ void loadArray(Config& cfg, const Path& path, std::istream& json)
 
         load(cfg, Path(path, i), token, json);
 
-        token = nextToken(json);
+        token = readToken(json);
         if (token.type() == Token::Separator) {
-            token = nextToken(json);
+            token = readToken(json);
             continue;
         }
 
@@ -111,24 +152,24 @@ void loadArray(Config& cfg, const Path& path, std::istream& json)
 }
 
 
-void loadLinkString(Config& cfg, const Path& path, Token token)
+void loadLinkString(Loader& cfg, const Path& path, Token token)
 {
     cfg.link(path, token.stringValue());
 }
 
-void loadLinkArray(Config& cfg, const Path& path, std::istream& json)
+void loadLinkArray(Loader& cfg, const Path& path, BufferContext& json)
 {
-    Token token = nextToken(json);
+    Token token = readToken(json);
     if (token.type() == Token::ArrayEnd) return;
 
     for (size_t i = 0; json; ++i) {
 
         loadLink(cfg, Path(path, i), token, json);
 
-        token = nextToken(json);
+        token = readToken(json);
 
         if (token.type() == Token::Separator) {
-            token = nextToken(json);
+            token = readToken(json);
             continue;
         }
 
@@ -139,7 +180,7 @@ void loadLinkArray(Config& cfg, const Path& path, std::istream& json)
     reflectError("unexpected end of array");
 }
 
-void loadLink(Config& cfg, const Path& path, const Token& token, std::istream& json)
+void loadLink(Loader& cfg, const Path& path, const Token& token, BufferContext& json)
 {
     switch (token.type())
     {
@@ -151,20 +192,20 @@ void loadLink(Config& cfg, const Path& path, const Token& token, std::istream& j
     }
 }
 
-void loadLink(Config& cfg, const Path& path, std::istream& json)
+void loadLink(Loader& cfg, const Path& path, BufferContext& json)
 {
-    loadLink(cfg, path, nextToken(json), json);
+    loadLink(cfg, path, readToken(json), json);
 }
 
-void loadObject(Config& cfg, const Path& path, std::istream& json)
+void loadObject(Loader& cfg, const Path& path, BufferContext& json)
 {
-    Token token = nextToken(json);
+    Token token = readToken(json);
     if (token.type() == Token::ObjectEnd) return;
 
     while (json) {
 
         expectToken(token, Token::String);
-        expectToken(nextToken(json), Token::KeySeparator);
+        expectToken(readToken(json), Token::KeySeparator);
 
         bool isLink;
         std::string key, type;
@@ -183,9 +224,9 @@ void loadObject(Config& cfg, const Path& path, std::istream& json)
         else load(cfg, sub, json);
 
 
-        token = nextToken(json);
+        token = readToken(json);
         if (token.type() == Token::Separator) {
-            token = nextToken(json);
+            token = readToken(json);
             continue;
         }
 
@@ -197,7 +238,7 @@ void loadObject(Config& cfg, const Path& path, std::istream& json)
 }
 
 
-void load(Config& cfg, const Path& path, const Token& token, std::istream& json)
+void load(Loader& cfg, const Path& path, const Token& token, BufferContext& json)
 {
     switch(token.type())
     {
@@ -212,41 +253,461 @@ void load(Config& cfg, const Path& path, const Token& token, std::istream& json)
     }
 }
 
-void load(Config& cfg, const Path& path, std::istream& json)
+void load(Loader& cfg, const Path& path, BufferContext& json)
+{
+    load(cfg, path, readToken(json), json);
+}
+
+
+/******************************************************************************/
+/* PARALLEL LOAD                                                              */
+/******************************************************************************/
+
+struct Entry
+{
+    bool isLink;
+    std::string key;
+    std::string type;
+
+    const char* value;
+
+    // Only used for the root objects built by the workers.
+    bool isTask;
+    Loader loader;
+};
+
+void skipValue(BufferContext& json)
+{
+    size_t depth = 0;
+
+    do {
+        switch (readToken(json).type())
+        {
+        case Token::ArrayStart:
+        case Token::ObjectStart: depth++; break;
+
+        case Token::ArrayEnd:
+        case Token::ObjectEnd: depth--; break;
+
+        default: break;
+        }
+    } while (depth && json);
+
+    if (depth) reflectError("unexpected end of json");
+}
+
+// Splits the root object into its entries without loading any of them.
+std::vector<Entry> splitRoot(BufferContext& json)
+{
+    std::vector<Entry> entries;
+
+    expectToken(readToken(json), Token::ObjectStart);
+
+    Token token = readToken(json);
+    if (token.type() == Token::ObjectEnd) return entries;
+
+    while (json) {
+        expectToken(token, Token::String);
+        expectToken(readToken(json), Token::KeySeparator);
+
+        Entry entry;
+        std::tie(entry.isLink, entry.key, entry.type) =
+            parseKey(token.stringValue());
+
+        entry.value = json.cursor();
+        entry.isTask = !entry.isLink && !entry.type.empty();
+        entries.emplace_back(std::move(entry));
+
+        skipValue(json);
+
+        token = readToken(json);
+        if (token.type() == Token::Separator) {
+            token = readToken(json);
+            continue;
+        }
+
+        expectToken(token, Token::ObjectEnd);
+        return entries;
+    }
+
+    reflectError("unexpected end of object");
+}
+
+// Root objects with a type specifier only ever touch their own object so
+// they're constructed and filled concurrently. Workers claim the next
+// unclaimed object until there are none left.
+void buildRoots(
+        std::vector<Entry>& entries,
+        const char* buffer, size_t len,
+        size_t threads)
+{
+    std::vector<size_t> tasks;
+    for (size_t i = 0; i < entries.size(); ++i)
+        if (entries[i].isTask) tasks.push_back(i);
+
+    if (!threads)
+        threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    threads = std::min(threads, tasks.size());
+
+    std::atomic<size_t> next(0);
+    std::vector<std::exception_ptr> failures(threads);
+
+    auto build = [&] (Entry& entry) {
+        Path path(entry.key);
+        entry.loader.set(path, reflect::type(entry.type)->alloc());
+
+        BufferContext json(buffer, len);
+        json.seek(entry.value);
+        load(entry.loader, path, json);
+    };
+
+    // Anything that escapes a worker is rethrown on the calling thread.
+    auto work = [&] (size_t worker) {
+        try {
+            for (size_t i = next++; i < tasks.size(); i = next++)
+                build(entries[tasks[i]]);
+        }
+        catch (...) { failures[worker] = std::current_exception(); }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+
+    for (size_t i = 1; i < threads; ++i) workers.emplace_back(work, i);
+
+    if (threads) work(0);
+    for (auto& worker : workers) worker.join();
+
+    for (const auto& failure : failures)
+        if (failure) std::rethrow_exception(failure);
+}
+
+void loadParallel(Config& cfg, const char* buffer, size_t len, size_t threads)
 {
-    load(cfg, path, nextToken(json), json);
+    BufferContext json(buffer, len);
+    std::vector<Entry> entries = splitRoot(json);
 
+    buildRoots(entries, buffer, len, threads);
+
+    // Everything else is applied in document order as a sequential load would.
+    Loader loader(cfg);
+
+    for (Entry& entry : entries) {
+        Path path(entry.key);
+
+        if (entry.isTask) {
+            cfg.set(path, entry.loader.root);
+
+            auto& links = entry.loader.links;
+            loader.links.insert(loader.links.end(), links.begin(), links.end());
+            continue;
+        }
+
+        if (!entry.type.empty())
+            cfg.set(path, reflect::type(entry.type)->alloc());
+
+        json.seek(entry.value);
+        if (entry.isLink) loadLink(loader, path, json);
+        else load(loader, path, json);
+    }
+
+    cfg.link(loader.links);
 }
 
 } // namespace anonymous
 
 
-void loadJson(Config& cfg, std::istream& json)
+void loadJson(Config& cfg, const char* json, size_t len, size_t threads)
 {
-    load(cfg, Path(), json);
+    if (threads != 1) {
+        loadParallel(cfg, json, len, threads);
+        return;
+    }
+
+    BufferContext context(json, len);
+
+    Loader loader(cfg);
+    load(loader, Path(), context);
+    cfg.link(loader.links);
+}
+
+void loadJson(Config& cfg, const std::string& json, size_t threads)
+{
+    loadJson(cfg, json.data(), json.size(), threads);
 }
 
-void loadJson(Config& cfg, const std::string& json)
+void loadJson(Config& cfg, std::istream& json, size_t threads)
 {
-    std::stringstream ss(json);
-    loadJson(cfg, ss);
+    loadJson(cfg, readAll(json), threads);
 }
 
+void loadJsonFile(Config& cfg, const std::string& path, size_t threads)
+{
+    MappedFile file(path);
+    loadJson(cfg, file.data(), file.size(), threads);
+}
+
+
+/******************************************************************************/
+/* SAVER                                                                      */
+/******************************************************************************/
+
+namespace {
+
+/** Writes out the config in a form that loadJson reads back.
+
+    Root values that were allocated from a type are written with a type
+    specifier and links are written at the end of the root object as fully
+    qualified link keys. Values that are reached through a link are left to
+    the link to restore.
+ */
+struct Saver
+{
+    Saver(const Config& cfg, Writer& json, const std::string& trait) :
+        cfg(cfg), json(json),
+        filter(!trait.empty()), trait(filter ? Trait::find(trait) : Trait::Field),
+        links(cfg.linkTargets())
+    {}
+
+    void save()
+    {
+        auto keys = cfg.keys();
+        std::sort(keys.begin(), keys.end());
+
+        json.put('{');
+        bool first = true;
+
+        for (const auto& key : keys) {
+            Path path(key);
+            if (links.count(path)) continue;
+
+            Value value = cfg[path];
+            if (!value.is(Trait::Pointer)) {
+                saveKey(key, nullptr, first);
+                saveValue(value, path, 1);
+            }
+            else if (!value) {
+                saveKey(key, nullptr, first);
+                printNull(json);
+            }
+            else {
+                Value object = *value;
+                saveKey(key, &object.typeId(), first);
+                saveValue(object, path, 1);
+            }
+        }
+
+        saveLinks(first);
+
+        if (!first) newline(json, 0);
+        json.put('}');
+        newline(json, 0);
+    }
+
+private:
+
+    void saveKey(const std::string& key, const std::string* type, bool& first)
+    {
+        if (!first) json.put(',');
+        first = false;
+
+        newline(json, 1);
+
+        if (!type) printString(key, json);
+        else printString(key + "!" + *type, json);
+
+        json.put(':');
+        space(json, 1);
+    }
+
+    void saveValue(const Value& value, const Path& path, int indent)
+    {
+        const Type* type = value.type();
+
+        if (type->is(Trait::Bool)) printBool(value.copy<bool>(), json);
+        else if (type->is(Trait::Float)) printFloat(value.copy<double>(), json);
+        else if (type->is(Trait::Integer))
+            printInteger(value.copy<long>(), json);
+        else if (type->is(Trait::String))
+            printString(value.copy<std::string>(), json);
+
+        else if (type->is(Trait::Map)) saveMap(value, path, indent);
+        else if (type->is(Trait::List)) saveList(value, path, indent);
+
+        // Pointers can only be restored through links.
+        else if (type->is(Trait::Pointer)) printNull(json);
+
+        else if (!type->is(Trait::Primitive)) saveObject(value, path, indent);
+        else printNull(json);
+    }
+
+    void saveList(const Value& value, const Path& path, int indent)
+    {
+        static const Symbol sizeFn("size");
+
+        json.put('[');
+        bool first = true;
+
+        size_t n = value.call<size_t>(sizeFn);
+        for (size_t i = 0; i < n; ++i) {
+            Path item(path, i);
+            if (links.count(item)) continue;
+
+            if (!first) json.put(',');
+            first = false;
+
+            newline(json, inc(indent));
+            saveValue(value[i], item, inc(indent));
+        }
+
+        if (!first) newline(json, indent);
+        json.put(']');
+    }
+
+    void saveMap(const Value& value, const Path& path, int indent)
+    {
+        static const Symbol keysFn("keys");
+
+        json.put('{');
+        bool first = true;
+
+        auto keys = value.call< std::vector<std::string> >(keysFn);
+        std::sort(keys.begin(), keys.end());
+
+        for (const auto& key : keys) {
+            Path item(path, key);
+            if (links.count(item)) continue;
+
+            if (!first) json.put(',');
+            first = false;
+
+            newline(json, inc(indent));
+            printString(key, json);
+            json.put(':');
+            space(json, indent);
+
+            saveValue(value[key], item, inc(indent));
+        }
+
+        if (!first) newline(json, indent);
+        json.put('}');
+    }
+
+    void saveObject(const Value& value, const Path& path, int indent)
+    {
+        const Type* type = value.type();
+
+        json.put('{');
+        bool first = true;
+
+        for (const auto& field : type->fieldDescriptors()) {
+            // Only fields that can be read back are written.
+            if (!field.getter && !field.hasOffset()) continue;
+            if (!field.setter) continue;
+
+            if (filter && !type->functionIs(field.name, trait)) continue;
+
+            Path item(path, field.name.str());
+            if (links.count(item)) continue;
+
+            if (!first) json.put(',');
+            first = false;
+
+            newline(json, inc(indent));
+            printString(field.name.str(), json);
+            json.put(':');
+            space(json, indent);
+
+            saveValue(value.field(field), item, inc(indent));
+        }
+
+        if (!first) newline(json, indent);
+        json.put('}');
+    }
+
+    // Links to consecutive items of a list starting from 0 are written as a
+    // single link array like the ones they were most likely loaded from.
+    void saveLinks(bool& first)
+    {
+        std::map<Path, std::vector< std::pair<size_t, Path> > > arrays;
+
+        for (const auto& link : links) {
+            const Path& path = link.first;
+
+            if (path.size() > 1 && path.isIndex(path.size() - 1)) {
+                size_t index = path.index(path.size() - 1);
+                arrays[path.popBack()].emplace_back(index, link.second);
+            }
+            else saveLink(path, link.second, first);
+        }
+
+        for (auto& array : arrays) {
+            auto& items = array.second;
+            std::sort(items.begin(), items.end());
+
+            bool isArray = true;
+            for (size_t i = 0; i < items.size(); ++i)
+                isArray = isArray && items[i].first == i;
+
+            if (!isArray) {
+                for (const auto& item : items)
+                    saveLink(Path(array.first, item.first), item.second, first);
+                continue;
+            }
+
+            saveKey("#" + array.first.toString(), nullptr, first);
+            json.put('[');
+
+            for (size_t i = 0; i < items.size(); ++i) {
+                if (i) json.put(',');
+                newline(json, 2);
+                printString(items[i].second.toString(), json);
+            }
+
+            newline(json, 1);
+            json.put(']');
+        }
+    }
+
+    void saveLink(const Path& link, const Path& target, bool& first)
+    {
+        saveKey("#" + link.toString(), nullptr, first);
+        printString(target.toString(), json);
+    }
+
+    const Config& cfg;
+    Writer& json;
+
+    bool filter;
+    Trait trait;
+
+    const std::map<Path, Path>& links;
+};
+
+} // namespace anonymous
+
 
 /******************************************************************************/
 /* SAVE                                                                       */
 /******************************************************************************/
 
-void saveJson(const Config&, std::ostream&, const std::string&)
+void saveJson(const Config& cfg, Writer& json, const std::string& trait)
+{
+    Saver(cfg, json, trait).save();
+}
+
+void saveJson(const Config& cfg, std::ostream& json, const std::string& trait)
 {
-    reflectError("saveJson is not implemented yet");
+    StreamWriter writer(json);
+    saveJson(cfg, writer, trait);
+    writer.flush();
 }
 
 std::string saveJson(const Config& cfg, const std::string& trait)
 {
-    std::stringstream ss;
-    saveJson(cfg, ss, trait);
-    return ss.str();
+    StringWriter writer;
+    saveJson(cfg, writer, trait);
+    return writer.str();
 }
 
 } // namespace config
@@ -6,6 +6,7 @@
 */
 
 #include "includes.h"
+#include "utils/json/writer.h"
 #pragma once
 
 namespace reflect {
@@ -15,14 +16,31 @@ namespace config {
 /* LOAD                                                                       */
 /******************************************************************************/
 
-void loadJson(Config& config, std::istream& json);
-void loadJson(Config& config, const std::string& json);
+/** Root objects with a type specifier (eg. "name!Type") can be constructed
+    and filled by up to threads workers. The default of 1 loads everything on
+    the calling thread while 0 picks a count based on the number of available
+    cores. Everything else is applied on the calling thread in the order in
+    which it appears and the links are resolved last.
+ */
+void loadJson(Config& config, std::istream& json, size_t threads = 1);
+void loadJson(Config& config, const std::string& json, size_t threads = 1);
+void loadJson(
+        Config& config, const char* json, size_t len, size_t threads = 1);
+
+// The file is memory mapped and parsed in place.
+void loadJsonFile(
+        Config& config, const std::string& path, size_t threads = 1);
 
 
 /******************************************************************************/
 /* SAVE                                                                       */
 /******************************************************************************/
 
+/** Writes the config in a form that can be read back by loadJson. Only the
+    object fields that have the given trait are written and an empty trait
+    writes all of them.
+ */
+
 std::string saveJson(
         const Config& config,
         const std::string& trait = "config");
@@ -32,5 +50,10 @@ void saveJson(
         std::ostream& json,
         const std::string& trait = "config");
 
+void saveJson(
+        const Config& config,
+        json::Writer& json,
+        const std::string& trait = "config");
+
 } // namespace config
 } // namespace reflect
@@ -26,7 +26,7 @@ has(const Path& path, size_t index) const
 {
     if (index == path.size()) return true;
 
-    auto it = children.find(path[index]);
+    auto it = children.find(path.findSymbol(index));
     if (it == children.end()) return false;
 
     return it->second->has(path, index + 1);
@@ -38,20 +38,32 @@ get(const Path& path, size_t index)
 {
     if (index == path.size()) return this;
 
-    auto it = children.find(path[index]);
+    auto it = children.find(path.findSymbol(index));
     if (it == children.end())
-        it = children.emplace(path[index], new Node).first;
+        it = children.emplace(path.symbol(index), new Node).first;
 
     return it->second->get(path, index + 1);
 }
 
+const Node*
+Node::
+find(const Path& path, size_t index) const
+{
+    if (index == path.size()) return this;
+
+    auto it = children.find(path.findSymbol(index));
+    if (it == children.end()) return nullptr;
+
+    return it->second->find(path, index + 1);
+}
+
 void
 Node::
 subtree(std::vector<LinkPair>& result, Path path) const
 {
     for (auto& link : links) result.emplace_back(path, link);
     for (auto child : children)
-        child.second->subtree(result, Path(path, child.first));
+        child.second->subtree(result, path.pushBack(child.first));
 }
 
 auto
@@ -81,7 +93,7 @@ erase(const Path& path, size_t index)
         return;
     }
 
-    auto it = children.find(path[index]);
+    auto it = children.find(path.findSymbol(index));
     if (it == children.end()) return;
 
     Node* node = it->second;
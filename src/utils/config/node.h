@@ -22,6 +22,10 @@ struct Node
     bool has(const Path& path, size_t index = 0) const;
     Node* get(const Path& path, size_t index = 0);
 
+    // Same as get but returns null instead of creating missing nodes.
+    const Node* find(const Path& path, size_t index = 0) const;
+    bool empty() const { return links.empty() && children.empty(); }
+
     typedef std::pair<Path, Path> LinkPair;
     std::vector<LinkPair> subtree() const;
 
@@ -32,7 +36,7 @@ private:
     void subtree(std::vector<LinkPair>& result, Path prefix) const;
 
     std::set<Path> links;
-    std::unordered_map<std::string, Node*> children;
+    std::unordered_map<Symbol, Node*> children;
 };
 
 } // namespace config
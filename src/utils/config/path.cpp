@@ -18,10 +18,72 @@ namespace config {
 /* PATH                                                                       */
 /******************************************************************************/
 
+namespace {
+
+// Components made of digits that don't overflow are indexes. Index is left
+// untouched if the component isn't one.
+bool parseIndex(const std::string& component, size_t& index)
+{
+    if (component.empty()) return false;
+
+    size_t value = 0;
+    for (char c : component) {
+        if (!std::isdigit(c)) return false;
+
+        size_t digit = c - '0';
+        if (value > (size_t(-2) - digit) / 10) return false;
+        value = value * 10 + digit;
+    }
+
+    index = value;
+    return true;
+}
+
+} // namespace anonymous
+
+auto
+Path::
+makeItem(const std::string& component) -> Item
+{
+    Item item;
+
+    if (parseIndex(component, item.index))
+        item.digits = component;
+    else item.symbol = Symbol(component);
+
+    return item;
+}
+
+auto
+Path::
+makeItem(Symbol symbol) -> Item
+{
+    Item item;
+    item.symbol = symbol;
+
+    if (parseIndex(symbol.str(), item.index))
+        item.digits = symbol.str();
+
+    return item;
+}
+
+bool
+Path::
+sameItem(const Item& lhs, const Item& rhs)
+{
+    if (!lhs.symbol.empty() && !rhs.symbol.empty())
+        return lhs.symbol == rhs.symbol;
+
+    return lhs.isIndex() && rhs.isIndex() && lhs.digits == rhs.digits;
+}
+
 void
 Path::
-parse(const std::string& path, char sep)
+parse(Items& items, const std::string& path, char sep)
 {
+    // Reused across components so that long components allocate at most once.
+    std::string item;
+
     size_t i = 0;
     while (i < path.size()) {
 
@@ -30,20 +92,45 @@ parse(const std::string& path, char sep)
         if (j == std::string::npos) j = path.size();
         if (i == j) reflectError("empty path component <%s>", path);
 
-        items.push_back(path.substr(i, j - i));
+        item.assign(path, i, j - i);
+        items.emplace_back(makeItem(item));
         i = j + 1;
     }
 }
 
+void
+Path::
+copy(Items& items) const
+{
+    for (size_t i = 0; i < size(); ++i)
+        items.push_back(item(i));
+}
+
+void
+Path::
+init(Items&& items)
+{
+    first_ = 0;
+    last_ = items.size();
+
+    if (last_ <= InlineSize)
+        std::move(items.begin(), items.end(), inline_);
+    else items_ = std::make_shared<const Items>(std::move(items));
+}
+
 std::string
 Path::
 toString(char sep) const
 {
+    size_t n = size();
+    for (size_t i = 0; i < size(); ++i) n += operator[](i).size();
+
     std::string path;
+    path.reserve(n);
 
-    for (size_t i = 0; i < items.size(); ++i) {
+    for (size_t i = 0; i < size(); ++i) {
         if (i) path += sep;
-        path += items[i];
+        path += operator[](i);
     }
 
     return path;
@@ -53,75 +140,133 @@ toString(char sep) const
 Path::
 Path(const std::string& path, char sep)
 {
-    parse(path, sep);
+    Items items;
+    parse(items, path, sep);
+    init(std::move(items));
 }
 
 Path::
 Path(const char* path, char sep)
 {
-    parse(path, sep);
+    Items items;
+    parse(items, path, sep);
+    init(std::move(items));
 }
 
 Path::
-Path(const Path& prefix, const std::string& path, char sep) :
-    items(prefix.items)
+Path(const Path& prefix, const std::string& path, char sep)
 {
-    parse(path, sep);
+    Items items;
+    items.reserve(prefix.size() + 1);
+
+    prefix.copy(items);
+    parse(items, path, sep);
+    init(std::move(items));
 }
 
 Path::
-Path(const Path& prefix, size_t index) :
-    items(prefix.items)
+Path(const Path& prefix, size_t index)
 {
-    items.emplace_back(std::to_string(index));
+    Item item;
+    item.index = index;
+    item.digits = std::to_string(index);
+
+    *this = prefix.pushBack(std::move(item));
 }
 
-bool
+Symbol
 Path::
-isIndex(size_t index) const
+symbol(size_t index) const
 {
-    const auto& item = items[index];
+    const Item& component = item(index);
+    if (!component.symbol.empty()) return component.symbol;
+    return Symbol(component.digits);
+}
 
-    for (char c : item) {
-        if (!std::isdigit(c)) return false;
-    }
-    return true;
+Symbol
+Path::
+findSymbol(size_t index) const
+{
+    const Item& component = item(index);
+    if (!component.symbol.empty()) return component.symbol;
+    return Symbol::find(component.digits);
 }
 
 size_t
 Path::
 index(size_t index) const
 {
-    const auto& item = items[index];
+    const Item& component = item(index);
 
-    for (char c : item) {
-        if (!std::isdigit(c))
-            reflectError("component at <%s> is not an index <%s>", index, item);
+    if (!component.isIndex()) {
+        reflectError("component at <%s> is not an index <%s>",
+                index, component.str());
     }
 
-    return std::stoull(item);
+    return component.index;
 }
 
 Path
 Path::
 popFront() const
 {
-    if (items.empty()) reflectError("pop on an empty path");
+    if (empty()) reflectError("pop on an empty path");
+    if (size() == 1) return Path();
 
-    Path result;
-    result.items.insert(result.items.begin(), items.begin() + 1, items.end());
-    return std::move(result);
+    Path result(*this);
+    result.first_++;
+    return result;
 }
 
 Path
 Path::
 popBack() const
 {
-    if (items.empty()) reflectError("pop on an empty path");
+    if (empty()) reflectError("pop on an empty path");
+    if (size() == 1) return Path();
 
+    Path result(*this);
+    result.last_--;
+    return result;
+}
+
+Path
+Path::
+pushBack(Symbol item) const
+{
+    return pushBack(makeItem(item));
+}
+
+Path
+Path::
+pushBack(Item item) const
+{
     Path result;
-    result.items.insert(result.items.begin(), items.begin(), items.end() - 1);
-    return std::move(result);
+
+    if (size() < InlineSize) {
+        for (size_t i = 0; i < size(); ++i)
+            result.inline_[i] = this->item(i);
+
+        result.inline_[size()] = std::move(item);
+        result.last_ = size() + 1;
+        return result;
+    }
+
+    Items items;
+    items.reserve(size() + 1);
+
+    copy(items);
+    items.push_back(std::move(item));
+
+    result.init(std::move(items));
+    return result;
+}
+
+bool
+Path::
+sameComponent(size_t index, const Path& other) const
+{
+    return sameItem(item(index), other.item(index));
 }
 
 bool
@@ -129,10 +274,12 @@ Path::
 operator<(const Path& other) const
 {
     for (size_t i = 0; i < std::min(size(), other.size()); ++i) {
-        int res = items[i].compare(other[i]);
-        if (!res) continue;
+        const Item& lhs = item(i);
+        const Item& rhs = other.item(i);
+        if (sameItem(lhs, rhs)) continue;
 
-        return res < 0;
+        // Distinct components never have the same characters.
+        return lhs.str() < rhs.str();
     }
 
     return size() < other.size();
@@ -147,51 +294,299 @@ operator<(const Path& other) const
 
 bool has(Value value, const Path& path, size_t index)
 {
+    static const Symbol size("size");
+    static const Symbol keyType("keyType");
+    static const Symbol count("count");
+
     if (index == path.size()) return true;
 
     if (value.type()->isPointer())
         return has(*value, path, index);
 
-    if (value.is("list")) {
+    if (value.is(Trait::List)) {
         if (!path.isIndex(index)) return false;
-        if (path.index(index) >= value.call<size_t>("size")) return false;
+        if (path.index(index) >= value.call<size_t>(size)) return false;
 
         return has(value[path.index(index)], path, index + 1);
     }
 
-    if (value.is("map")) {
-        if (value.type()->call<const Type*>("keyType") != type<std::string>())
+    if (value.is(Trait::Map)) {
+        if (value.type()->call<const Type*>(keyType) != type<std::string>())
             return false;
 
-        if (!value.call<size_t>("count", path[index]))
+        if (!value.call<size_t>(count, path[index]))
             return false;
 
         return has(value[path[index]], path, index + 1);
     }
 
-    if (!value.type()->hasField(path[index])) return false;
+    Symbol name = path.findSymbol(index);
+    const FieldDescriptor* field = value.type()->fieldDescriptor(name);
+    if (!field) return false;
 
-    return has(value.get<Value>(path[index]), path, index + 1);
+    return has(value.field(*field), path, index + 1);
 }
 
 
 Value get(Value value, const Path& path, size_t index)
 {
+    static const Symbol resize("resize");
+
     if (index == path.size()) return value;
 
     if (value.type()->isPointer())
         return get(*value, path, index);
 
-    if (value.is("list")) {
+    if (value.is(Trait::List)) {
         if (!value.isConst())
-            value.call<void>("resize", path.index(index) + 1);
+            value.call<void>(resize, path.index(index) + 1);
         return get(value[path.index(index)], path, index + 1);
     }
 
-    if (value.is("map"))
+    if (value.is(Trait::Map))
         return get(value[path[index]], path, index + 1);
 
-    return get(value.get<Value>(path[index]), path, index + 1);
+    Symbol name = path.findSymbol(index);
+    const FieldDescriptor* field = value.type()->fieldDescriptor(name);
+    if (!field) return get(value.get<Value>(path[index]), path, index + 1);
+
+    return get(value.field(*field), path, index + 1);
+}
+
+
+/******************************************************************************/
+/* COMPILED PATH                                                              */
+/******************************************************************************/
+
+CompiledPath::
+CompiledPath(const Type* root, Path path, size_t first) :
+    root_(root), path_(std::move(path)), first_(first), compiled_(first)
+{
+    compile();
+}
+
+void
+CompiledPath::
+compile()
+{
+    static const Symbol deref("operator*");
+
+    const Type* type = root_;
+
+    while (type && compiled_ < path_.size()) {
+        Step step = { Step::Deref, compiled_, type, 0, nullptr,
+                      nullptr, nullptr, nullptr };
+
+        if (type->isPointer()) {
+            if (!type->pointee() || !type->hasFunction(deref)) return;
+
+            Argument ptr(type, RefType::LValue, false);
+            auto at = type->function(deref).resolve(
+                    Argument::make<Value>(), &ptr, 1);
+            if (at.status != Overloads::Found) return;
+
+            step.at = at.fn;
+            type = type->pointee();
+            steps_.push_back(step);
+            continue;
+        }
+
+        bool compiled;
+        if (type->is(Trait::List)) compiled = compileList(step, type);
+        else if (type->is(Trait::Map)) compiled = compileMap(step, type);
+        else compiled = compileField(step, type);
+        if (!compiled) return;
+
+        steps_.push_back(step);
+        compiled_++;
+    }
+}
+
+bool
+CompiledPath::
+compileList(Step& step, const Type*& type)
+{
+    static const Symbol valueType("valueType");
+    static const Symbol size("size");
+    static const Symbol resize("resize");
+    static const Symbol at("operator[]");
+
+    if (!path_.isIndex(step.component)) return false;
+
+    for (Symbol fn : { valueType, size, resize, at })
+        if (!type->hasFunction(fn)) return false;
+
+    Argument list(type, RefType::LValue, false);
+    Argument args[] = { list, Argument::make<size_t>() };
+
+    auto sizeFn = type->function(size).resolve(
+            Argument::make<size_t>(), &list, 1);
+    auto resizeFn = type->function(resize).resolve(
+            Argument::make<void>(), args, 2);
+    auto atFn = type->function(at).resolve(Argument::make<Value>(), args, 2);
+
+    if (sizeFn.status != Overloads::Found) return false;
+    if (resizeFn.status != Overloads::Found) return false;
+    if (atFn.status != Overloads::Found) return false;
+
+    step.kind = Step::List;
+    step.index = path_.index(step.component);
+    step.size = sizeFn.fn;
+    step.resize = resizeFn.fn;
+    step.at = atFn.fn;
+
+    type = type->call<const Type*>(valueType);
+    return true;
+}
+
+bool
+CompiledPath::
+compileMap(Step& step, const Type*& type)
+{
+    static const Symbol keyType("keyType");
+    static const Symbol valueType("valueType");
+    static const Symbol count("count");
+    static const Symbol at("operator[]");
+
+    for (Symbol fn : { keyType, valueType, count, at })
+        if (!type->hasFunction(fn)) return false;
+
+    if (type->call<const Type*>(keyType) != reflect::type<std::string>())
+        return false;
+
+    Argument args[] = {
+        Argument(type, RefType::LValue, false),
+        Argument::make<const std::string&>()
+    };
+
+    auto countFn = type->function(count).resolve(
+            Argument::make<size_t>(), args, 2);
+    auto atFn = type->function(at).resolve(Argument::make<Value>(), args, 2);
+
+    if (countFn.status != Overloads::Found) return false;
+    if (atFn.status != Overloads::Found) return false;
+
+    step.kind = Step::Map;
+    step.size = countFn.fn;
+    step.at = atFn.fn;
+
+    type = type->call<const Type*>(valueType);
+    return true;
+}
+
+bool
+CompiledPath::
+compileField(Step& step, const Type*& type)
+{
+    const FieldDescriptor* field =
+        type->fieldDescriptor(path_.findSymbol(step.component));
+    if (!field || !field->type) return false;
+    if (!field->getter && !field->hasOffset()) return false;
+
+    step.kind = Step::Field;
+    step.field = field;
+
+    type = field->type;
+    return true;
+}
+
+// Applies the compiled steps up to the last component and stops early if the
+// type of a value doesn't match what was expected. Const values also bail out
+// since the functions were resolved against mutable values.
+//
+// Values returned by value (getters for example) are held in owner since the
+// values that follow refer to their content.
+Value
+CompiledPath::
+walk(Value value, size_t last, size_t& component, Value& owner) const
+{
+    component = std::min(compiled_, last);
+
+    for (const Step& step : steps_) {
+        if (step.component >= last
+                || value.type() != step.type
+                || value.isConst())
+        {
+            component = step.component;
+            break;
+        }
+
+        if (value.isStored()) owner = value;
+
+        switch (step.kind)
+        {
+        case Step::Deref:
+            value = step.at->invoke<Value>(value);
+            break;
+
+        case Step::List:
+            step.resize->invoke<void>(value, step.index + 1);
+            value = step.at->invoke<Value>(value, step.index);
+            break;
+
+        case Step::Map:
+            value = step.at->invoke<Value>(value, path_[step.component]);
+            break;
+
+        case Step::Field:
+            value = value.field(*step.field);
+            break;
+        }
+    }
+
+    return value;
+}
+
+bool
+CompiledPath::
+has(Value value) const
+{
+    Value owner;
+    size_t component = compiled_;
+
+    for (const Step& step : steps_) {
+        if (value.type() != step.type || value.isConst()) {
+            component = step.component;
+            break;
+        }
+
+        if (value.isStored()) owner = value;
+
+        switch (step.kind)
+        {
+        case Step::Deref:
+            value = step.at->invoke<Value>(value);
+            break;
+
+        case Step::List:
+            if (step.index >= step.size->invoke<size_t>(value)) return false;
+            value = step.at->invoke<Value>(value, step.index);
+            break;
+
+        case Step::Map: {
+            const std::string& key = path_[step.component];
+            if (!step.size->invoke<size_t>(value, key)) return false;
+            value = step.at->invoke<Value>(value, key);
+            break;
+        }
+
+        case Step::Field:
+            value = value.field(*step.field);
+            break;
+        }
+    }
+
+    return config::has(value, path_, component);
+}
+
+Value
+CompiledPath::
+get(Value value) const
+{
+    Value owner;
+    size_t component;
+    value = walk(value, path_.size(), component, owner);
+    return config::get(value, path_, component);
 }
 
 
@@ -15,37 +15,100 @@ namespace config {
 /* PATH                                                                       */
 /******************************************************************************/
 
+/** Keys are interned as symbols while indexes are stored along with their
+    text and are only interned if their symbol is requested. Walking large
+    lists therefore never grows the symbol table.
+
+    Short paths keep their components inline while longer ones store them in
+    an immutable array which is shared between a path and all the paths
+    sliced from it. Copying or popping a path is therefore constant time,
+    pushing onto a short path never allocates and comparisons only look at
+    the characters of components that differ.
+ */
 struct Path
 {
-    Path() {}
+    Path() : first_(0), last_(0) {}
     Path(const char* path, char sep = '.');
     Path(const std::string& path, char sep = '.');
     Path(const Path& prefix, size_t index);
     Path(const Path& prefix, const std::string& path, char sep = '.');
 
-    explicit operator bool() const { return items.empty(); }
+    explicit operator bool() const { return empty(); }
 
-    bool empty() const { return items.empty(); }
-    size_t size() const { return items.size(); }
-    const std::string& operator[] (size_t index) const { return items[index]; }
+    bool empty() const { return first_ == last_; }
+    size_t size() const { return last_ - first_; }
 
-    bool isIndex(size_t index) const;
+    const std::string& operator[] (size_t index) const
+    {
+        return item(index).str();
+    }
+
+    // Interns the component if it's an index that was never interned.
+    Symbol symbol(size_t index) const;
+
+    // Returns the empty symbol instead of interning an index.
+    Symbol findSymbol(size_t index) const;
+
+    bool isIndex(size_t index) const { return item(index).isIndex(); }
     size_t index(size_t index) const;
 
-    const std::string& front() const { return items.front(); }
+    const std::string& front() const { return operator[](0); }
     Path popFront() const;
 
-    const std::string& back() const { return items.back(); }
+    const std::string& back() const { return operator[](size() - 1); }
     Path popBack() const;
+    Path pushBack(Symbol item) const;
 
+    bool sameComponent(size_t index, const Path& other) const;
     bool operator<(const Path& other) const;
 
     std::string toString(char sep = '.') const;
 
 private:
-    void parse(const std::string& path, char sep);
 
-    std::vector<std::string> items;
+    struct Item
+    {
+        enum : size_t { NotIndex = size_t(-1) };
+
+        Item() : index(NotIndex) {}
+
+        // Empty for indexes that weren't created from a symbol.
+        Symbol symbol;
+
+        size_t index;
+        std::string digits;
+
+        bool isIndex() const { return index != NotIndex; }
+        const std::string& str() const
+        {
+            return isIndex() ? digits : symbol.str();
+        }
+    };
+
+    typedef std::vector<Item> Items;
+
+    enum { InlineSize = 4 };
+
+    const Item& item(size_t index) const
+    {
+        const Item* items = items_ ? items_->data() : inline_;
+        return items[first_ + index];
+    }
+
+    static Item makeItem(const std::string& component);
+    static Item makeItem(Symbol symbol);
+    static bool sameItem(const Item& lhs, const Item& rhs);
+
+    Path pushBack(Item item) const;
+
+    void copy(Items& items) const;
+    void init(Items&& items);
+    static void parse(Items& items, const std::string& path, char sep);
+
+    std::shared_ptr<const Items> items_;
+    Item inline_[InlineSize];
+    size_t first_;
+    size_t last_;
 };
 
 
@@ -91,5 +154,69 @@ Ret call(Value value, const Path& path, Args&&... args)
 }
 
 
+/******************************************************************************/
+/* COMPILED PATH                                                              */
+/******************************************************************************/
+
+/** Path bound to the type of the value that it will be applied to. Every
+    component is resolved once against the types along the path: indexes are
+    parsed, fields are looked up and the functions used to walk lists, maps and
+    pointers are resolved ahead of time.
+
+    Values whose type doesn't match the one the path was compiled against (eg.
+    a pointer to a child type) are walked like a regular path from that
+    component onwards. The same goes for the components that couldn't be
+    resolved statically.
+ */
+struct CompiledPath
+{
+    CompiledPath() : root_(nullptr), first_(0), compiled_(0) {}
+    CompiledPath(const Type* root, Path path, size_t first = 0);
+
+    const Type* root() const { return root_; }
+    const Path& path() const { return path_; }
+    size_t first() const { return first_; }
+
+    bool has(Value value) const;
+    Value get(Value value) const;
+
+    template<typename Arg>
+    void set(Value value, Arg&& arg) const;
+
+private:
+
+    struct Step
+    {
+        enum Kind { Deref, List, Map, Field };
+
+        Kind kind;
+        size_t component;
+        const Type* type;
+
+        size_t index;
+        const FieldDescriptor* field;
+
+        const Function* at;     // operator* or operator[]
+        const Function* size;   // size for lists and count for maps
+        const Function* resize;
+    };
+
+    void compile();
+    bool compileList(Step& step, const Type*& type);
+    bool compileMap(Step& step, const Type*& type);
+    bool compileField(Step& step, const Type*& type);
+
+    Value walk(
+            Value value, size_t last, size_t& component, Value& owner) const;
+
+    const Type* root_;
+    Path path_;
+    size_t first_;
+
+    size_t compiled_;
+    std::vector<Step> steps_;
+};
+
+
 } // namespace config
 } // namespace reflect
@@ -15,20 +15,46 @@ namespace details {
 template<typename Arg>
 void set(Value value, const Path& path, size_t index, Arg&& arg)
 {
+    static const Symbol resize("resize");
+
     if (value.type()->isPointer())
         details::set(*value, path, index, std::forward<Arg>(arg));
 
-    else if (value.is("list")) {
-        value.call<void>("resize", path.index(index) + 1);
+    else if (value.is(Trait::List)) {
+        value.call<void>(resize, path.index(index) + 1);
         value[path.index(index)].assign(std::forward<Arg>(arg));
     }
 
-    else if (value.is("map"))
+    else if (value.is(Trait::Map))
         value[path[index]].assign(std::forward<Arg>(arg));
 
     else value.set(path[index], std::forward<Arg>(arg));
 }
 
 } // namespace details
+
+
+/******************************************************************************/
+/* COMPILED PATH                                                              */
+/******************************************************************************/
+
+template<typename Arg>
+void
+CompiledPath::
+set(Value value, Arg&& arg) const
+{
+    if (path_.size() <= first_) reflectError("set on an empty path");
+
+    size_t last = path_.size() - 1;
+
+    Value owner;
+    size_t component;
+    value = walk(value, last, component, owner);
+    if (component < last)
+        value = config::get(value, path_.popBack(), component);
+
+    details::set(value, path_, last, std::forward<Arg>(arg));
+}
+
 } // namespace config
 } // namespace reflect
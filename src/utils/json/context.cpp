@@ -0,0 +1,66 @@
+/* context.cpp                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   json parsing context implementation.
+*/
+
+#include "context.h"
+
+namespace reflect {
+namespace json {
+
+/******************************************************************************/
+/* ERROR                                                                      */
+/******************************************************************************/
+
+void
+Error::
+prefix(const std::string& key)
+{
+    std::string component = "/";
+    component.reserve(key.size() + 1);
+
+    for (char c : key) {
+        if (c == '~') component += "~0";
+        else if (c == '/') component += "~1";
+        else component += c;
+    }
+
+    path.insert(0, component);
+}
+
+void
+Error::
+prefix(size_t index)
+{
+    path.insert(0, "/" + std::to_string(index));
+}
+
+std::string
+Error::
+print() const
+{
+    return errorFormat("%lu:%lu: %s%s%s",
+            pos.row + 1, pos.col + 1,
+            path, path.empty() ? "" : ": ", message);
+}
+
+
+/******************************************************************************/
+/* BUFFER CONTEXT                                                             */
+/******************************************************************************/
+
+void
+BufferContext::
+fail(std::string message)
+{
+    if (failed_) return;
+
+    failed_ = true;
+    error_ = Error(pos(), std::move(message));
+    it_ = end_;
+}
+
+} // namespace json
+} // namespace reflect
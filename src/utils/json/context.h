@@ -7,6 +7,11 @@
 
 #pragma once
 
+#include "reflect.h"
+
+#include <string>
+#include <istream>
+
 namespace reflect {
 namespace json {
 
@@ -19,8 +24,6 @@ struct Pos
     Pos() : row(0), col(0) {}
     Pos(size_t row, size_t col) : row(row), col(col) {}
 
-    void newline(size_t count = 1) { col = 0; row += count; }
-
     size_t row;
     size_t col;
 };
@@ -33,192 +36,130 @@ struct Pos
 struct Error
 {
     Error() {}
-    Error(std::string msg, std::string path, Pos pos) :
-        msg_(std::move(msg)), path_(std::move(path)), pos_(std::move(pos))
+    Error(Pos pos, std::string message) :
+        pos(pos), message(std::move(message))
     {}
 
-    const Pos& pos() const { return pos_; }
-    const std::string& msg() const { return msg_; }
-    const std::string& path() const { return path_; }
-
-private:
-    Pos pos_;
-    std::string path_;
-    std::string msg_;
-};
-
-
-/******************************************************************************/
-/* CONTEXT                                                                    */
-/******************************************************************************/
-
-struct ContextBase
-{
-    ContextBase() : pos(0), line(0), lineStart(0) {}
-
-    Pos pos() const { return Pos(line, pos - lineStart); }
-    void newline() const
-    {
-        line++;
-        lineStart = pos;
-    }
-
-    void enter(std::string name) { path_.emplace_back(std::move(name)); }
-    void enter(size_t index) { path_.emplace_back(std::to_string(index)); }
-    void exit() { path_.pop_back(); }
+    Pos pos;
 
-    std::string path(char sep = '.') const
-    {
-        std::stringstream ss;
-        for (size_t i = 0; i < path_; ++i) {
-            if (i) ss << sep;
-            ss << path_[i];
-        }
-        return ss.str();
-    }
-
-    const std::vector<Error>& errors() const { return errors_; }
+    // json pointer (RFC 6901) to the value that failed to parse.
+    std::string path;
 
-    template<typename... Args>
-    void error(std::string fmt, Args&&... args)
-    {
-        std::string err = errorFormat(fmt, std::forward<Args>(args));
-        errors_.emplace_back(std::move(err), path(), pos());
-    }
+    std::string message;
 
-protected:
-    size_t pos;
-private:
-    size_t line;
-    size_t linePos;
+    // Errors are raised where they happen and the path is filled in as the
+    // parser unwinds back to the root.
+    void prefix(const std::string& key);
+    void prefix(size_t index);
 
-    std::vector<std::string> path_;
-    std::vector<Error> errors_;
+    std::string print() const;
 };
 
 
 /******************************************************************************/
-/* CONTEXT PTR                                                                */
+/* BUFFER CONTEXT                                                             */
 /******************************************************************************/
 
-struct ContextPtr
+/** Cursor over a contiguous json buffer which is read in place by the
+    tokenizer. The buffer doesn't need to be null terminated and must outlive
+    the context along with any tokens read from it.
+
+    Row and column are not tracked while reading and are only computed when
+    requested (eg. for error reporting).
+
+    Malformed input doesn't abort the parse. Instead the first error is
+    recorded and the cursor skips to the end of the buffer which makes every
+    loop of the parser bail out. Callers check failed() once done.
+ */
+struct BufferContext
 {
-    ContextPtr() {}
-    ContextPtr(const char* ptr, size_t n) : ptr(ptr), len(n) {}
-    void init(const char* ptr, size_t n) { ptr = ptr; len = n; }
+    BufferContext(const char* buffer, size_t len) :
+        start_(buffer), it_(buffer), end_(buffer + len), failed_(false)
+    {}
 
-    std::string toString() const { return std::string(ptr, len); }
+    explicit BufferContext(const std::string& str) :
+        BufferContext(str.data(), str.size())
+    {}
 
-    long toInt() const
-    {
-        const char* end = ptr + len;
-        long value = strtol(ptr, &end, 10);
+    BufferContext(const BufferContext&) = delete;
+    BufferContext& operator=(const BufferContext&) = delete;
 
-        if (end == ptr + len) return value;
-        reflectError("failed conversion to int <%s>", toString());
-    }
+    explicit operator bool() const { return it_ < end_; }
 
-    double toFloat() const
-    {
-        const char* end = ptr + len;
-        double value = strtod(ptr, &end, 10);
+    size_t tell() const { return it_ - start_; }
+    size_t size() const { return end_ - start_; }
 
-        if (end == ptr + len) return value;
-        reflectError("failed conversion to float <%s>", toString());
-    }
+    const char* cursor() const { return it_; }
+    const char* end() const { return end_; }
+    void seek(const char* it) { it_ = it; }
 
-    bool toBool() const
+    char peek() const { return *it_; }
+    char pop() { return *it_++; }
+
+    /** Moves the cursor to the start of a new buffer which begins at base
+        within the document. Used to read a stream one chunk at a time while
+        still reporting positions relative to the whole document.
+     */
+    void reset(const char* buffer, size_t len, Pos base)
     {
-        if (!strncmp(buffer, "true")) return true;
-        if (!strncmp(buffer, "false")) return true;
-        reflectError("failed conversion to bool <%s>", toString());
+        start_ = it_ = buffer;
+        end_ = buffer + len;
+        base_ = base;
     }
 
-private:
-    const char* ptr;
-    const size_t len;
-};
-
-struct ContextStringPtr : public ContextPtr
-{
-    ContextStringPtr(std::string str) : str(std::move(str))
+    Pos pos() const
     {
-        init(str.c_str(), str.size());
+        Pos pos = base_;
+        for (const char* it = start_; it < it_; ++it) {
+            if (*it != '\n') pos.col++;
+            else { pos.row++; pos.col = 0; }
+        }
+        return pos;
     }
 
-private:
-    std::string str;
-};
-
-
-/******************************************************************************/
-/* STRING CONTEXT                                                             */
-/******************************************************************************/
-
-struct BufferContext : public ContextBase
-{
-    typedef ContextPtr Ptr;
-
-    BufferContext(std::string& str) : buffer(str.c_str()), len(str.size()) {}
-    BufferContext(const char* buffer, size_t len) : buffer(buffer), len(len) {}
-
-    operator bool() const { return pos < len; }
-    size_t tell() const { return pos; }
+    bool failed() const { return failed_; }
+    const Error& error() const { return error_; }
+    Error& error() { return error_; }
 
-    char pop() { return buffer[pos++]; }
-    char peek() const { return buffer[pos]; }
-
-    Ptr get(size_t start, size_t n) const
+    template<typename... Args>
+    void fail(const char* fmt, Args&&... args)
     {
-        if (start + n > len)
-            reflectError("range <%lu, %lu> is out of bounds <%lu>", start, n, len);
-        return ContextPtr(buffer + pos, n);
+        if (failed_) return;
+        fail(errorFormat(fmt, std::forward<Args>(args)...));
     }
 
+    void fail(std::string message);
+
 private:
-    const char* buffer;
-    size_t len;
+    const char* start_;
+    const char* it_;
+    const char* end_;
+    Pos base_;
+
+    bool failed_;
+    Error error_;
 };
 
 
 /******************************************************************************/
-/* STREAM CONTEXT                                                             */
+/* READ ALL                                                                   */
 /******************************************************************************/
 
-struct StreamContext : public ContextBase
+/** The tokenizer needs the entire input in a single buffer so streams are
+    read to the end before being parsed.
+ */
+inline std::string readAll(std::istream& stream)
 {
-    typedef ContextStringPtr Ptr;
-
-    StreamContext(std::ostream& stream) :
-        stream(stream), streamStart(stream.tellg())
-    {}
-
-    operator bool() const { return stream; }
-    size_t tell() const { return pos; }
-
-    char pop() { return stream.pop(); pos++; }
-    char peek() const { return stream.peek(); }
+    std::string buffer;
 
-    Ptr get(size_t start, size_t n) const
-    {
-        if (start + n > pos)
-            reflectError("range <%lu, %lu> is out of bounds <%lu>", start, n, pos);
-
-        stream.seekg(streamStart + start);
-
-        std::string buffer(n, 0);
-        stream.read(buffer.data(), n);
-
-        stream.seekg(streamStart + pos);
-
-        return Ptr(std::move(buffer));
+    char chunk[4096];
+    while (stream) {
+        stream.read(chunk, sizeof(chunk));
+        buffer.append(chunk, stream.gcount());
     }
 
-private:
-    std::istream& stream;
-    size_t streamStart;
-};
-
+    return buffer;
+}
 
 } // namespace json
 } // namespace reflect
@@ -0,0 +1,419 @@
+/* decoder.cpp                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   Compiled json decoders implementation.
+*/
+
+#include "decoder.h"
+#include "scalar.h"
+
+#include <cstring>
+
+namespace reflect {
+namespace json {
+
+/******************************************************************************/
+/* UTILS                                                                      */
+/******************************************************************************/
+
+namespace {
+
+template<typename T, typename Arg>
+void store(void* target, Arg value)
+{
+    T typed = value;
+    std::memcpy(target, &typed, sizeof(T));
+}
+
+template<typename Int>
+void storeInt(void* target, size_t size, Int value)
+{
+    typedef typename std::make_unsigned<Int>::type UInt;
+    typedef typename std::conditional<std::is_signed<Int>::value,
+            int8_t, uint8_t>::type Int8;
+    typedef typename std::conditional<std::is_signed<Int>::value,
+            int16_t, uint16_t>::type Int16;
+    typedef typename std::conditional<std::is_signed<Int>::value,
+            int32_t, uint32_t>::type Int32;
+    typedef typename std::conditional<std::is_signed<Int>::value,
+            int64_t, UInt>::type Int64;
+
+    switch (size)
+    {
+    case 1: store<Int8>(target, value); break;
+    case 2: store<Int16>(target, value); break;
+    case 4: store<Int32>(target, value); break;
+    case 8: store<Int64>(target, value); break;
+    default: reflectError("unsupported integer size <%lu>", size);
+    }
+}
+
+// FNV-1a
+size_t hashKey(const char* key, size_t len)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= uint8_t(key[i]);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+enum : uint32_t { EmptySlot = uint32_t(-1) };
+
+
+/******************************************************************************/
+/* DECODER CACHE                                                              */
+/******************************************************************************/
+
+// The lock is recursive because compiling a decoder compiles the decoders of
+// all the types it refers to.
+//
+// Lookups go through an immutable snapshot of the compiled decoders which is
+// published once the outermost compilation completes. This keeps readers
+// from locking and from seeing a decoder that is still being compiled. Older
+// snapshots are kept around since readers might still be using them.
+struct DecoderCache
+{
+    typedef std::unordered_map<const Type*, const Decoder*> Snapshot;
+
+    DecoderCache() : depth(0)
+    {
+        std::unique_ptr<Snapshot> snapshot(new Snapshot);
+        current = snapshot.get();
+        snapshots.emplace_back(std::move(snapshot));
+    }
+
+    const Decoder* find(const Type* type) const
+    {
+        const Snapshot* snapshot = current.load(std::memory_order_acquire);
+
+        auto it = snapshot->find(type);
+        return it != snapshot->end() ? it->second : nullptr;
+    }
+
+    void publish()
+    {
+        std::unique_ptr<Snapshot> next(new Snapshot);
+        for (const auto& entry : decoders)
+            next->emplace(entry.first, entry.second.get());
+
+        current.store(next.get(), std::memory_order_release);
+        snapshots.emplace_back(std::move(next));
+    }
+
+    std::atomic<const Snapshot*> current;
+
+    std::recursive_mutex lock;
+    size_t depth;
+    std::unordered_map<const Type*, std::unique_ptr<Decoder> > decoders;
+    std::vector< std::unique_ptr<Snapshot> > snapshots;
+};
+
+// Intentionally leaked along with the types that the decoders refer to.
+DecoderCache& getDecoderCache()
+{
+    static DecoderCache* cache = new DecoderCache();
+    return *cache;
+}
+
+} // namespace anonymous
+
+
+/******************************************************************************/
+/* DECODER                                                                    */
+/******************************************************************************/
+
+Decoder::
+Decoder(const Type* type) :
+    type_(type), kind_(Generic), size_(0),
+    item_(nullptr), pushBack_(nullptr), isDirectPushBack_(false)
+{}
+
+const Decoder& decoder(const Type* type)
+{
+    auto& cache = getDecoderCache();
+    if (const Decoder* decoder = cache.find(type)) return *decoder;
+
+    std::lock_guard<std::recursive_mutex> guard(cache.lock);
+
+    auto it = cache.decoders.find(type);
+    if (it != cache.decoders.end()) return *it->second;
+
+    // Registered before being compiled so that recursive types can refer to
+    // their own decoder.
+    Decoder* decoder = new Decoder(type);
+    cache.decoders.emplace(type, std::unique_ptr<Decoder>(decoder));
+
+    cache.depth++;
+    decoder->compile();
+    if (!--cache.depth) cache.publish();
+
+    return *decoder;
+}
+
+void
+Decoder::
+compile()
+{
+    Scalar scalar = json::scalar(type_);
+
+    switch (scalar.kind)
+    {
+    case Scalar::Bool: kind_ = Bool; break;
+    case Scalar::Int: kind_ = Int; break;
+    case Scalar::UInt: kind_ = UInt; break;
+    case Scalar::Float: kind_ = Float; break;
+    case Scalar::String: kind_ = String; break;
+    case Scalar::None: break;
+    }
+
+    if (kind_ != Generic) {
+        size_ = scalar.size;
+        return;
+    }
+
+    if (type_->is(Trait::List))
+        compileList();
+
+    else if (!type_->is(Trait::Primitive)
+            && !type_->is(Trait::Pointer)
+            && !type_->is(Trait::String)
+            && !type_->is(Trait::Map))
+        compileObject();
+}
+
+void
+Decoder::
+compileList()
+{
+    static const Symbol valueType("valueType");
+    static const Symbol pushBack("push_back");
+
+    if (!type_->hasFunction(valueType) || !type_->hasFunction(pushBack))
+        return;
+
+    const Type* itemType = type_->call<const Type*>(valueType);
+
+    Argument ret = Argument::make<void>();
+    std::vector<Argument> args = {
+        Argument(type_, RefType::LValue, false),
+        Argument(itemType, RefType::RValue, false)
+    };
+
+    auto result = type_->function(pushBack).resolve(ret, args.data(), 2);
+    if (result.status != Overloads::Found) return;
+
+    kind_ = List;
+    pushBack_ = result.fn;
+    isDirectPushBack_ = result.isDirect;
+    item_ = &decoder(itemType);
+}
+
+void
+Decoder::
+compileObject()
+{
+    const auto& descriptors = type_->fieldDescriptors();
+    fields_.reserve(descriptors.size());
+
+    for (const FieldDescriptor& desc : descriptors) {
+        if (!desc.type) continue;
+
+        const std::string& name = desc.name.str();
+        size_t hash = hashKey(name.data(), name.size());
+        fields_.push_back(Field{ name, hash, &desc, nullptr });
+    }
+
+    kind_ = Object;
+
+    for (Field& field : fields_)
+        field.decoder = &decoder(field.field->type);
+
+    size_t size = 8;
+    while (size < fields_.size() * 2) size *= 2;
+    slots_.resize(size, EmptySlot);
+
+    for (size_t i = 0; i < fields_.size(); ++i) {
+        size_t slot = fields_[i].hash & (size - 1);
+        while (slots_[slot] != EmptySlot) slot = (slot + 1) & (size - 1);
+        slots_[slot] = i;
+    }
+}
+
+auto
+Decoder::
+field(const char* key, size_t len) const -> const Field*
+{
+    if (slots_.empty()) return nullptr;
+
+    size_t hash = hashKey(key, len);
+    size_t mask = slots_.size() - 1;
+
+    for (size_t slot = hash & mask; ; slot = (slot + 1) & mask) {
+        uint32_t index = slots_[slot];
+        if (index == EmptySlot) return nullptr;
+
+        const Field& field = fields_[index];
+        if (field.hash != hash || field.name.size() != len) continue;
+        if (!std::memcmp(field.name.data(), key, len)) return &field;
+    }
+}
+
+
+/******************************************************************************/
+/* DECODE                                                                     */
+/******************************************************************************/
+
+void
+Decoder::
+decode(const Value& target, const Token& token, BufferContext& json) const
+{
+    void* ptr = target.value();
+
+    // Anything that doesn't match the compiled representation is handed over
+    // to the generic parser which will either handle it or report the error.
+    switch (target.isConst() ? Generic : kind_)
+    {
+    case Bool:
+        if (token.type() != Token::Bool) break;
+        store<bool>(ptr, token.boolValue());
+        return;
+
+    case Int: {
+        if (token.type() != Token::Number) break;
+
+        long value;
+        if (token.intValue(value)) storeInt<long>(ptr, size_, value);
+        else json.fail("integer out of range <%s>", token.stringValue());
+        return;
+    }
+
+    case UInt: {
+        if (token.type() != Token::Number) break;
+
+        unsigned long value;
+        if (token.uintValue(value)) storeInt<unsigned long>(ptr, size_, value);
+        else json.fail("integer out of range <%s>", token.stringValue());
+        return;
+    }
+
+    case Float:
+        if (token.type() != Token::Number) break;
+        if (size_ == sizeof(float)) store<float>(ptr, token.floatValue());
+        else store<double>(ptr, token.floatValue());
+        return;
+
+    case String:
+        if (token.type() != Token::String) break;
+        static_cast<std::string*>(ptr)->assign(token.data(), token.size());
+        return;
+
+    case List:
+        if (token.type() != Token::ArrayStart) break;
+        decodeList(target, json);
+        return;
+
+    case Object:
+        if (token.type() != Token::ObjectStart) break;
+        decodeObject(target, json);
+        return;
+
+    case Generic: break;
+    }
+
+    parseGeneric(target, token, json);
+}
+
+void
+Decoder::
+decodeList(const Value& target, BufferContext& json) const
+{
+    Token token = nextToken(json);
+    if (token.type() == Token::ArrayEnd) return;
+
+    for (size_t i = 0; json; ++i) {
+
+        Value item = item_->type()->construct();
+        item_->decode(item, token, json);
+        if (json.failed()) return json.error().prefix(i);
+
+        if (isDirectPushBack_)
+            pushBack_->invokeDirect<void>(target, item.rvalue());
+        else pushBack_->invoke<void>(target, item.rvalue());
+
+        token = nextToken(json);
+        if (token.type() == Token::Separator) {
+            token = nextToken(json);
+            continue;
+        }
+
+        expectToken(token, Token::ArrayEnd, json);
+        return;
+    }
+
+    json.fail("unexpected end of array");
+}
+
+void
+Decoder::
+decodeObject(const Value& target, BufferContext& json) const
+{
+    Token token = nextToken(json);
+    if (token.type() == Token::ObjectEnd) return;
+
+    while (json) {
+
+        if (!expectToken(token, Token::String, json)) return;
+
+        const Field* field = this->field(token.data(), token.size());
+        if (!field) {
+            return json.fail("<%s> doesn't have a field <%s>",
+                    type_->id(), token.stringValue());
+        }
+
+        if (!expectToken(nextToken(json), Token::KeySeparator, json)) return;
+
+        const FieldDescriptor& desc = *field->field;
+        const Decoder& decoder = *field->decoder;
+        token = nextToken(json);
+
+        // Scalars completely overwrite their target so they can be decoded in
+        // place. Everything else is decoded into a fresh value which then
+        // replaces the field like a regular assignment would.
+        bool isScalar = decoder.kind_ != Generic
+            && decoder.kind_ != List && decoder.kind_ != Object;
+
+        if (isScalar && desc.hasOffset())
+            decoder.decode(target.field(desc), token, json);
+
+        else if (desc.setter) {
+            Value item = desc.type->construct();
+            decoder.decode(item, token, json);
+            if (!json.failed())
+                desc.setter->invoke<void>(target, item.rvalue());
+        }
+
+        else {
+            json.fail("<%s> has no setter for field <%s>",
+                    type_->id(), desc.name);
+        }
+
+        if (json.failed()) return json.error().prefix(field->name);
+
+        token = nextToken(json);
+        if (token.type() == Token::Separator) {
+            token = nextToken(json);
+            continue;
+        }
+
+        expectToken(token, Token::ObjectEnd, json);
+        return;
+    }
+
+    json.fail("unexpected end of object");
+}
+
+} // namespace json
+} // namespace reflect
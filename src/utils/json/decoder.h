@@ -0,0 +1,91 @@
+/* decoder.h                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   Compiled json decoders.
+
+   A decoder is built once per type and contains everything required to
+   decode a json value into that type: the concrete representation of
+   primitives, a hash table of the fields of objects along with their
+   pre-resolved descriptors and the decoders of children types. Decoding
+   objects of the same shape over and over therefore requires no name lookups
+   and no overload resolution.
+
+   Types which can't be compiled (maps, pointers, etc.) fall back on the event
+   based parser.
+*/
+
+#pragma once
+
+#include "token.h"
+
+namespace reflect {
+namespace json {
+
+/******************************************************************************/
+/* DECODER                                                                    */
+/******************************************************************************/
+
+struct Decoder
+{
+    enum Kind { Generic, Bool, Int, UInt, Float, String, List, Object };
+
+    explicit Decoder(const Type* type);
+
+    Decoder(const Decoder&) = delete;
+    Decoder& operator=(const Decoder&) = delete;
+
+    const Type* type() const { return type_; }
+    Kind kind() const { return kind_; }
+
+    // Decodes the value starting at token into target which must be an
+    // lvalue of the decoder's type.
+    void decode(
+            const Value& target, const Token& token, BufferContext& json) const;
+
+private:
+    friend const Decoder& decoder(const Type* type);
+
+    struct Field
+    {
+        std::string name;
+        size_t hash;
+        const FieldDescriptor* field;
+        const Decoder* decoder;
+    };
+
+    void compile();
+    void compileList();
+    void compileObject();
+
+    const Field* field(const char* key, size_t len) const;
+
+    void decodeList(const Value& target, BufferContext& json) const;
+    void decodeObject(const Value& target, BufferContext& json) const;
+
+    const Type* type_;
+    Kind kind_;
+    size_t size_;
+
+    const Decoder* item_;
+    const Function* pushBack_;
+    bool isDirectPushBack_;
+
+    std::vector<Field> fields_;
+    std::vector<uint32_t> slots_; // open addressing into fields_.
+};
+
+// Decoders are built on first use and are never freed.
+const Decoder& decoder(const Type* type);
+
+
+/******************************************************************************/
+/* PARSE GENERIC                                                              */
+/******************************************************************************/
+
+// Event based parsing of a value whose first token was already read. Defined
+// in parser.cpp.
+void parseGeneric(const Value& value, const Token& token, BufferContext& json);
+
+} // namespace json
+} // namespace reflect
@@ -0,0 +1,311 @@
+/* encoder.cpp                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   Compiled json encoders implementation.
+*/
+
+#include "encoder.h"
+#include "scalar.h"
+#include "token.h"
+
+#include <cstring>
+
+namespace reflect {
+namespace json {
+
+/******************************************************************************/
+/* UTILS                                                                      */
+/******************************************************************************/
+
+namespace {
+
+template<typename T>
+T load(const void* source)
+{
+    T value;
+    std::memcpy(&value, source, sizeof(T));
+    return value;
+}
+
+long loadInt(const void* source, size_t size)
+{
+    switch (size)
+    {
+    case 1: return load<int8_t>(source);
+    case 2: return load<int16_t>(source);
+    case 4: return load<int32_t>(source);
+    case 8: return load<int64_t>(source);
+    default: reflectError("unsupported integer size <%lu>", size);
+    }
+}
+
+unsigned long loadUInt(const void* source, size_t size)
+{
+    switch (size)
+    {
+    case 1: return load<uint8_t>(source);
+    case 2: return load<uint16_t>(source);
+    case 4: return load<uint32_t>(source);
+    case 8: return load<uint64_t>(source);
+    default: reflectError("unsupported integer size <%lu>", size);
+    }
+}
+
+
+/******************************************************************************/
+/* ENCODER CACHE                                                              */
+/******************************************************************************/
+
+// The lock is recursive because compiling an encoder compiles the encoders of
+// all the types it refers to.
+//
+// Lookups go through an immutable snapshot of the compiled encoders which is
+// published once the outermost compilation completes. This keeps readers
+// from locking and from seeing an encoder that is still being compiled. Older
+// snapshots are kept around since readers might still be using them.
+struct EncoderCache
+{
+    typedef std::unordered_map<const Type*, const Encoder*> Snapshot;
+
+    EncoderCache() : depth(0)
+    {
+        std::unique_ptr<Snapshot> snapshot(new Snapshot);
+        current = snapshot.get();
+        snapshots.emplace_back(std::move(snapshot));
+    }
+
+    const Encoder* find(const Type* type) const
+    {
+        const Snapshot* snapshot = current.load(std::memory_order_acquire);
+
+        auto it = snapshot->find(type);
+        return it != snapshot->end() ? it->second : nullptr;
+    }
+
+    void publish()
+    {
+        std::unique_ptr<Snapshot> next(new Snapshot);
+        for (const auto& entry : encoders)
+            next->emplace(entry.first, entry.second.get());
+
+        current.store(next.get(), std::memory_order_release);
+        snapshots.emplace_back(std::move(next));
+    }
+
+    std::atomic<const Snapshot*> current;
+
+    std::recursive_mutex lock;
+    size_t depth;
+    std::unordered_map<const Type*, std::unique_ptr<Encoder> > encoders;
+    std::vector< std::unique_ptr<Snapshot> > snapshots;
+};
+
+// Intentionally leaked along with the types that the encoders refer to.
+EncoderCache& getEncoderCache()
+{
+    static EncoderCache* cache = new EncoderCache();
+    return *cache;
+}
+
+} // namespace anonymous
+
+
+/******************************************************************************/
+/* ENCODER                                                                    */
+/******************************************************************************/
+
+Encoder::
+Encoder(const Type* type) :
+    type_(type), kind_(Generic), size_(0),
+    item_(nullptr), sizeFn_(nullptr), atFn_(nullptr)
+{}
+
+const Encoder& encoder(const Type* type)
+{
+    auto& cache = getEncoderCache();
+    if (const Encoder* encoder = cache.find(type)) return *encoder;
+
+    std::lock_guard<std::recursive_mutex> guard(cache.lock);
+
+    auto it = cache.encoders.find(type);
+    if (it != cache.encoders.end()) return *it->second;
+
+    // Registered before being compiled so that recursive types can refer to
+    // their own encoder.
+    Encoder* encoder = new Encoder(type);
+    cache.encoders.emplace(type, std::unique_ptr<Encoder>(encoder));
+
+    cache.depth++;
+    encoder->compile();
+    if (!--cache.depth) cache.publish();
+
+    return *encoder;
+}
+
+void
+Encoder::
+compile()
+{
+    Scalar scalar = json::scalar(type_);
+
+    switch (scalar.kind)
+    {
+    case Scalar::Bool: kind_ = Bool; break;
+    case Scalar::Int: kind_ = Int; break;
+    case Scalar::UInt: kind_ = UInt; break;
+    case Scalar::Float: kind_ = Float; break;
+    case Scalar::String: kind_ = String; break;
+    case Scalar::None: break;
+    }
+
+    if (kind_ != Generic) {
+        size_ = scalar.size;
+        return;
+    }
+
+    if (type_->is(Trait::Map)) return;
+
+    if (type_->is(Trait::List))
+        compileList();
+
+    else if (!type_->is(Trait::Primitive)
+            && !type_->is(Trait::Pointer)
+            && !type_->is(Trait::String))
+        compileObject();
+}
+
+void
+Encoder::
+compileList()
+{
+    static const Symbol valueType("valueType");
+    static const Symbol sizeFn("size");
+    static const Symbol atFn("operator[]");
+
+    if (!type_->hasFunction(valueType)) return;
+    if (!type_->hasFunction(sizeFn) || !type_->hasFunction(atFn)) return;
+
+    const Type* itemType = type_->call<const Type*>(valueType);
+
+    Argument list(type_, RefType::LValue, true);
+    Argument index = Argument::make<size_t>();
+
+    auto size = type_->function(sizeFn).resolve(
+            Argument::make<size_t>(), &list, 1);
+    if (size.status != Overloads::Found) return;
+
+    Argument args[] = { list, index };
+    auto at = type_->function(atFn).resolve(Argument::make<Value>(), args, 2);
+    if (at.status != Overloads::Found) return;
+
+    kind_ = List;
+    sizeFn_ = size.fn;
+    atFn_ = at.fn;
+    item_ = &reflect::json::encoder(itemType);
+}
+
+void
+Encoder::
+compileObject()
+{
+    const auto& descriptors = type_->fieldDescriptors();
+    fields_.reserve(descriptors.size());
+
+    for (const FieldDescriptor& desc : descriptors) {
+        if (!desc.type || (!desc.getter && !desc.hasOffset())) continue;
+
+        StringWriter key;
+        printString(desc.name.str(), key);
+        fields_.push_back(Field{ key.str(), &desc, nullptr });
+    }
+
+    kind_ = Object;
+
+    for (Field& field : fields_)
+        field.encoder = &reflect::json::encoder(field.field->type);
+}
+
+
+/******************************************************************************/
+/* ENCODE                                                                     */
+/******************************************************************************/
+
+void
+Encoder::
+encode(const Value& value, Writer& json, int indent) const
+{
+    const void* ptr = value.value();
+
+    switch (kind_)
+    {
+    case Bool: printBool(load<bool>(ptr), json); break;
+    case Int: printInteger(loadInt(ptr, size_), json); break;
+    case UInt: printInteger(loadUInt(ptr, size_), json); break;
+
+    case Float:
+        if (size_ == sizeof(float)) printFloat(load<float>(ptr), json);
+        else printFloat(load<double>(ptr), json);
+        break;
+
+    case String:
+        printString(*static_cast<const std::string*>(ptr), json);
+        break;
+
+    case List: encodeList(value, json, indent); break;
+    case Object: encodeObject(value, json, indent); break;
+    case Generic: printGeneric(value, json, indent); break;
+    }
+}
+
+void
+Encoder::
+encodeList(const Value& value, Writer& json, int indent) const
+{
+    json.put('[');
+
+    size_t n = sizeFn_->invoke<size_t>(value);
+
+    for (size_t i = 0; i < n; ++i) {
+        if (i) json.put(',');
+        newline(json, inc(indent));
+
+        Value item = atFn_->invoke<Value>(value, i);
+
+        if (item.type() != item_->type()) printGeneric(item, json, inc(indent));
+        else item_->encode(item, json, inc(indent));
+    }
+
+    if (n) newline(json, indent);
+    json.put(']');
+}
+
+void
+Encoder::
+encodeObject(const Value& value, Writer& json, int indent) const
+{
+    json.put('{');
+
+    for (size_t i = 0; i < fields_.size(); ++i) {
+        const Field& field = fields_[i];
+
+        if (i) json.put(',');
+        newline(json, inc(indent));
+
+        json.write(field.key.data(), field.key.size());
+        json.put(':');
+        space(json, indent);
+
+        Value item = value.field(*field.field);
+
+        const Encoder& child = *field.encoder;
+        if (item.type() != child.type()) printGeneric(item, json, inc(indent));
+        else child.encode(item, json, inc(indent));
+    }
+
+    if (!fields_.empty()) newline(json, indent);
+    json.put('}');
+}
+
+} // namespace json
+} // namespace reflect
@@ -0,0 +1,82 @@
+/* encoder.h                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   Compiled json encoders.
+
+   Counterpart of the decoders: built once per type, an encoder knows the
+   concrete representation of primitives, the pre-escaped keys and the
+   resolved accessors of the fields of objects along with the encoders of
+   children types. Types which can't be compiled (maps, pointers, etc.) fall
+   back on the generic printer.
+*/
+
+#pragma once
+
+#include "reflect.h"
+#include "writer.h"
+
+
+namespace reflect {
+namespace json {
+
+/******************************************************************************/
+/* ENCODER                                                                    */
+/******************************************************************************/
+
+struct Encoder
+{
+    enum Kind { Generic, Bool, Int, UInt, Float, String, List, Object };
+
+    explicit Encoder(const Type* type);
+
+    Encoder(const Encoder&) = delete;
+    Encoder& operator=(const Encoder&) = delete;
+
+    const Type* type() const { return type_; }
+    Kind kind() const { return kind_; }
+
+    // A negative indent disables pretty printing.
+    void encode(const Value& value, Writer& json, int indent) const;
+
+private:
+    friend const Encoder& encoder(const Type* type);
+
+    struct Field
+    {
+        std::string key; // quoted and escaped.
+        const FieldDescriptor* field;
+        const Encoder* encoder;
+    };
+
+    void compile();
+    void compileList();
+    void compileObject();
+
+    void encodeList(const Value& value, Writer& json, int indent) const;
+    void encodeObject(const Value& value, Writer& json, int indent) const;
+
+    const Type* type_;
+    Kind kind_;
+    size_t size_;
+
+    const Encoder* item_;
+    const Function* sizeFn_;
+    const Function* atFn_;
+
+    std::vector<Field> fields_;
+};
+
+// Encoders are built on first use and are never freed.
+const Encoder& encoder(const Type* type);
+
+
+/******************************************************************************/
+/* PRINT GENERIC                                                              */
+/******************************************************************************/
+
+// Prints values that don't have a compiled encoder. Defined in printer.cpp.
+void printGeneric(const Value& value, Writer& json, int indent);
+
+} // namespace json
+} // namespace reflect
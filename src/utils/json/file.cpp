@@ -0,0 +1,63 @@
+/* file.cpp                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   Memory mapped json input implementation.
+*/
+
+#include "file.h"
+#include "reflect.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace reflect {
+namespace json {
+
+/******************************************************************************/
+/* MAPPED FILE                                                                */
+/******************************************************************************/
+
+MappedFile::
+MappedFile(const std::string& path) :
+    data_(nullptr), size_(0)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) reflectError("unable to open <%s>: %s", path, strerror(errno));
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        int err = errno;
+        close(fd);
+        reflectError("unable to stat <%s>: %s", path, strerror(err));
+    }
+
+    size_ = st.st_size;
+
+    // mmap refuses empty mappings and an empty buffer is all we need anyway.
+    if (size_) {
+        void* ptr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        int err = errno;
+        close(fd);
+
+        if (ptr == MAP_FAILED)
+            reflectError("unable to map <%s>: %s", path, strerror(err));
+
+        (void) madvise(ptr, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(ptr);
+    }
+    else close(fd);
+}
+
+MappedFile::
+~MappedFile()
+{
+    if (data_) munmap(const_cast<char*>(data_), size_);
+}
+
+} // namespace json
+} // namespace reflect
@@ -0,0 +1,41 @@
+/* file.h                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   Memory mapped json input.
+*/
+
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+namespace reflect {
+namespace json {
+
+/******************************************************************************/
+/* MAPPED FILE                                                                */
+/******************************************************************************/
+
+/** Read-only mapping of an entire file which can be handed over to the
+    tokenizer as is. The mapping is advised for sequential access since that's
+    how the tokenizer reads it.
+ */
+struct MappedFile
+{
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_;
+    size_t size_;
+};
+
+} // namespace json
+} // namespace reflect
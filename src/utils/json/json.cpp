@@ -5,6 +5,16 @@
    Json build file.
 */
 
+#include "context.cpp"
+#include "scan.cpp"
+#include "number.cpp"
+#include "writer.cpp"
+#include "file.cpp"
+#include "scalar.cpp"
 #include "token.cpp"
+#include "sax.cpp"
 #include "parser.cpp"
+#include "lines.cpp"
+#include "decoder.cpp"
 #include "printer.cpp"
+#include "encoder.cpp"
@@ -0,0 +1,62 @@
+/* lines.cpp                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   Newline delimited json parser implementation.
+*/
+
+#include "lines.h"
+
+#include <algorithm>
+
+namespace reflect {
+namespace json {
+
+/******************************************************************************/
+/* LINES                                                                      */
+/******************************************************************************/
+
+namespace {
+
+// Below this, spinning up a thread costs more than decoding the lines.
+const size_t MinBytesPerWorker = 1 << 16;
+
+} // namespace anonymous
+
+size_t lineWorkers(size_t len)
+{
+    size_t cores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    return std::max<size_t>(std::min(cores, len / MinBytesPerWorker), 1);
+}
+
+std::vector<LineRange> splitLines(const char* buffer, size_t len, size_t n)
+{
+    std::vector<LineRange> ranges;
+    if (!len) return ranges;
+
+    n = std::max<size_t>(n, 1);
+    ranges.reserve(n);
+
+    const char* it = buffer;
+    const char* end = buffer + len;
+
+    for (size_t i = 1; i <= n && it < end; ++i) {
+        const char* split = i == n ? end : buffer + (len / n) * i;
+        if (split <= it) continue;
+
+        // Ranges end just past the first newline at or after the split point.
+        const char* last = end;
+        if (split < end) {
+            const void* newline = memchr(split - 1, '\n', end - (split - 1));
+            if (newline) last = static_cast<const char*>(newline) + 1;
+        }
+
+        ranges.push_back(LineRange{ it, last });
+        it = last;
+    }
+
+    return ranges;
+}
+
+} // namespace json
+} // namespace reflect
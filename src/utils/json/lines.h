@@ -0,0 +1,181 @@
+/* lines.h                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   Newline delimited json parser.
+*/
+
+#pragma once
+
+#include "reflect.h"
+#include "context.h"
+#include "parser.h"
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <istream>
+#include <cstring>
+#include <exception>
+
+namespace reflect {
+namespace json {
+
+/******************************************************************************/
+/* LINES                                                                      */
+/******************************************************************************/
+
+struct LineRange
+{
+    const char* first;
+    const char* last;
+};
+
+/** Splits the buffer into at most n ranges of roughly equal size which all
+    start at the beginning of a line and end just past a newline or at the end
+    of the buffer.
+ */
+std::vector<LineRange> splitLines(const char* buffer, size_t len, size_t n);
+
+// Number of workers to use if the caller doesn't specify a count.
+size_t lineWorkers(size_t len);
+
+/** Returns the next line in [it, end) and moves it past its newline. */
+inline LineRange nextLine(const char*& it, const char* end)
+{
+    const char* first = it;
+    const char* last = static_cast<const char*>(memchr(it, '\n', end - it));
+
+    if (!last) last = it = end;
+    else it = last + 1;
+
+    return LineRange{ first, last };
+}
+
+inline bool isBlank(LineRange line)
+{
+    for (const char* it = line.first; it < line.last; ++it) {
+        if (*it != ' ' && *it != '\t' && *it != '\r') return false;
+    }
+    return true;
+}
+
+
+/******************************************************************************/
+/* PARSE LINES                                                                */
+/******************************************************************************/
+
+/** Parses a buffer containing one json value per line, each of which is
+    decoded into a T. Blank lines are skipped and the values are returned in
+    the order in which they appear in the buffer.
+
+    The buffer is split into ranges of whole lines which are decoded in
+    parallel by up to threads workers; 0 picks a count based on the size of
+    the buffer and the number of available cores.
+
+    If errors is provided, lines that fail to parse are left out of the
+    result and reported along with their (0 based) row. Otherwise the first
+    error is raised along with its row.
+ */
+template<typename T>
+std::vector<T> parseLines(
+        const char* buffer, size_t len,
+        size_t threads = 0,
+        std::vector<Error>* errors = nullptr)
+{
+    if (!threads) threads = lineWorkers(len);
+    auto ranges = splitLines(buffer, len, threads);
+
+    std::vector< std::vector<T> > values(ranges.size());
+    std::vector< std::vector<Error> > rangeErrors(ranges.size());
+    std::vector<size_t> rows(ranges.size(), 0);
+    std::vector<std::exception_ptr> failures(ranges.size());
+
+    // Make sure everything is loaded before the workers start racing for it.
+    (void) type<T>();
+
+    auto parseRange = [&] (size_t i) {
+        const char* it = ranges[i].first;
+        const char* end = ranges[i].last;
+
+        for (size_t& row = rows[i]; it < end; ++row) {
+            LineRange line = nextLine(it, end);
+            if (isBlank(line)) continue;
+
+            values[i].emplace_back();
+            Value value(values[i].back());
+
+            const char* json = line.first;
+            size_t len = line.last - line.first;
+
+            auto& lineErrors = rangeErrors[i];
+            if (parseInto(value, json, len, lineErrors)) continue;
+
+            lineErrors.back().pos.row = row;
+            values[i].pop_back();
+
+            // Raised once the rows of the preceding ranges are known.
+            if (!errors) return;
+        }
+    };
+
+    // Anything that escapes a worker is rethrown on the calling thread.
+    auto work = [&] (size_t i) {
+        try { parseRange(i); }
+        catch (...) { failures[i] = std::current_exception(); }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(ranges.size());
+
+    for (size_t i = 1; i < ranges.size(); ++i)
+        workers.emplace_back(work, i);
+
+    if (!ranges.empty()) work(0);
+    for (auto& worker : workers) worker.join();
+
+    for (const auto& failure : failures)
+        if (failure) std::rethrow_exception(failure);
+
+    size_t total = 0;
+    for (const auto& range : values) total += range.size();
+
+    std::vector<T> result;
+    result.reserve(total);
+
+    size_t row = 0;
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        for (auto& value : values[i]) result.emplace_back(std::move(value));
+
+        for (auto& failed : rangeErrors[i]) {
+            failed.pos.row += row;
+            if (!errors) reflectError("%s", failed.print());
+            errors->emplace_back(std::move(failed));
+        }
+
+        row += rows[i];
+    }
+
+    return result;
+}
+
+template<typename T>
+std::vector<T> parseLines(
+        const std::string& buffer,
+        size_t threads = 0,
+        std::vector<Error>* errors = nullptr)
+{
+    return parseLines<T>(buffer.data(), buffer.size(), threads, errors);
+}
+
+template<typename T>
+std::vector<T> parseLines(
+        std::istream& stream,
+        size_t threads = 0,
+        std::vector<Error>* errors = nullptr)
+{
+    return parseLines<T>(readAll(stream), threads, errors);
+}
+
+} // namespace json
+} // namespace reflect
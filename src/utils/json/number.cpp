@@ -0,0 +1,591 @@
+/* number.cpp                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   Number parsing and formatting implementation.
+*/
+
+#include "number.h"
+#include "reflect.h"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace reflect {
+namespace json {
+
+/******************************************************************************/
+/* PARSE INT                                                                  */
+/******************************************************************************/
+
+namespace {
+
+bool isDecDigit(char c) { return c >= '0' && c <= '9'; }
+
+bool parseDigits(
+        const char* it, const char* end, uint64_t limit, uint64_t& value)
+{
+    if (it == end || !isDecDigit(*it)) return false;
+
+    value = 0;
+    for (; it != end && isDecDigit(*it); ++it) {
+        unsigned digit = *it - '0';
+        if (value > (limit - digit) / 10) return false;
+        value = value * 10 + digit;
+    }
+
+    return true;
+}
+
+} // namespace anonymous
+
+bool parseInt(const char* first, size_t len, long& value)
+{
+    bool negative = len && *first == '-';
+    uint64_t limit = uint64_t(INT64_MAX) + negative;
+
+    uint64_t digits;
+    if (!parseDigits(first + negative, first + len, limit, digits))
+        return false;
+
+    value = negative ? -digits : digits;
+    return true;
+}
+
+bool parseUInt(const char* first, size_t len, unsigned long& value)
+{
+    uint64_t digits;
+    if (!parseDigits(first, first + len, UINT64_MAX, digits)) return false;
+
+    value = digits;
+    return true;
+}
+
+long parseInt(const char* first, size_t len)
+{
+    long value;
+    if (!parseInt(first, len, value))
+        reflectError("invalid integer <%s>", std::string(first, len));
+    return value;
+}
+
+unsigned long parseUInt(const char* first, size_t len)
+{
+    unsigned long value;
+    if (!parseUInt(first, len, value))
+        reflectError("invalid integer <%s>", std::string(first, len));
+    return value;
+}
+
+
+/******************************************************************************/
+/* PARSE FLOAT                                                                */
+/******************************************************************************/
+
+namespace {
+
+// Every power of ten up to 1e22 is exactly representable as a double.
+const double exactPow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+const uint64_t MaxExactMantissa = uint64_t(1) << 53;
+
+double parseFloatSlow(const char* first, size_t len)
+{
+    // Numbers are not null terminated within the buffer so they're copied
+    // into a local buffer to keep strtod from reading past the end of the
+    // token.
+    std::array<char, 128> local;
+    std::string heap;
+
+    const char* str;
+    if (len < local.size()) {
+        std::memcpy(local.data(), first, len);
+        local[len] = '\0';
+        str = local.data();
+    }
+    else {
+        heap.assign(first, len);
+        str = heap.c_str();
+    }
+
+    char* end;
+    double value = strtod(str, &end);
+    if (end == str)
+        reflectError("invalid number <%s>", std::string(first, len));
+    return value;
+}
+
+} // namespace anonymous
+
+/** When both the mantissa and the power of ten are exactly representable as
+    doubles, a single IEEE multiplication or division yields the correctly
+    rounded result (Clinger's fast path). That covers the vast majority of the
+    numbers found in json documents; everything else goes through strtod.
+ */
+double parseFloat(const char* first, size_t len)
+{
+    const char* it = first;
+    const char* end = first + len;
+
+    bool negative = it != end && *it == '-';
+    if (negative) ++it;
+
+    if (it == end || !isDecDigit(*it)) return parseFloatSlow(first, len);
+
+    uint64_t mantissa = 0;
+    size_t digits = 0;
+    long exponent = 0;
+
+    for (; it != end && *it == '0'; ++it);
+
+    for (; it != end && isDecDigit(*it); ++it, ++digits)
+        mantissa = mantissa * 10 + (*it - '0');
+
+    if (it != end && *it == '.') {
+        ++it;
+
+        if (!digits) {
+            for (; it != end && *it == '0'; ++it) --exponent;
+        }
+
+        for (; it != end && isDecDigit(*it); ++it, ++digits, --exponent)
+            mantissa = mantissa * 10 + (*it - '0');
+    }
+
+    if (it != end && (*it == 'e' || *it == 'E')) {
+        ++it;
+
+        bool negativeExp = it != end && *it == '-';
+        if (it != end && (*it == '-' || *it == '+')) ++it;
+
+        if (it == end || !isDecDigit(*it)) return parseFloatSlow(first, len);
+
+        long value = 0;
+        for (; it != end && isDecDigit(*it); ++it)
+            if (value < 100000) value = value * 10 + (*it - '0');
+
+        exponent += negativeExp ? -value : value;
+    }
+
+    // 19 digits is the most that can be accumulated without overflowing.
+    if (digits > 19 || mantissa > MaxExactMantissa)
+        return parseFloatSlow(first, len);
+
+    double value = mantissa;
+
+    if (!mantissa || !exponent) {}
+    else if (exponent < 0 && exponent >= -22) value /= exactPow10[-exponent];
+    else if (exponent > 0 && exponent <= 22) value *= exactPow10[exponent];
+    else return parseFloatSlow(first, len);
+
+    return negative ? -value : value;
+}
+
+
+/******************************************************************************/
+/* FORMAT INT                                                                 */
+/******************************************************************************/
+
+size_t formatUInt(unsigned long value, char* buffer)
+{
+    char digits[NumberBufferSize];
+    char* it = digits + sizeof(digits);
+
+    do {
+        *--it = '0' + value % 10;
+        value /= 10;
+    } while (value);
+
+    size_t len = digits + sizeof(digits) - it;
+    std::memcpy(buffer, it, len);
+    return len;
+}
+
+size_t formatInt(long value, char* buffer)
+{
+    if (value >= 0) return formatUInt(value, buffer);
+
+    *buffer = '-';
+    return formatUInt(-static_cast<unsigned long>(value), buffer + 1) + 1;
+}
+
+
+/******************************************************************************/
+/* GRISU                                                                      */
+/******************************************************************************/
+
+/** Grisu2 as described by Florian Loitsch in "Printing Floating-Point Numbers
+    Quickly and Accurately with Integers". The number and its rounding
+    boundaries are scaled by a cached power of ten into a range where the
+    digits can be generated with 64 bits integer arithmetic.
+ */
+
+namespace {
+
+// 64 bits floating point number with a 64 bits mantissa: f * 2^e.
+struct DiyFp
+{
+    DiyFp() : f(0), e(0) {}
+    DiyFp(uint64_t f, int e) : f(f), e(e) {}
+
+    explicit DiyFp(double value)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        int biased = (bits & ExponentMask) >> SignificandSize;
+        uint64_t significand = bits & SignificandMask;
+
+        if (biased) {
+            f = significand + HiddenBit;
+            e = biased - ExponentBias;
+        }
+        else {
+            f = significand;
+            e = MinExponent + 1;
+        }
+    }
+
+    DiyFp operator-(const DiyFp& other) const
+    {
+        return DiyFp(f - other.f, e);
+    }
+
+    DiyFp operator*(const DiyFp& other) const
+    {
+        // 64x64 -> 128 multiply from 32-bit halves keeping only the rounded
+        // high half.
+        const uint64_t mask = 0xFFFFFFFF;
+        uint64_t a = f >> 32, b = f & mask;
+        uint64_t c = other.f >> 32, d = other.f & mask;
+
+        uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+
+        uint64_t mid = (bd >> 32) + (ad & mask) + (bc & mask);
+        mid += uint64_t(1) << 31; // round
+
+        uint64_t high = ac + (ad >> 32) + (bc >> 32) + (mid >> 32);
+        return DiyFp(high, e + other.e + 64);
+    }
+
+    DiyFp normalize() const
+    {
+        int shift = __builtin_clzll(f);
+        return DiyFp(f << shift, e - shift);
+    }
+
+    DiyFp normalizeBoundary() const
+    {
+        DiyFp result = *this;
+
+        while (!(result.f & (HiddenBit << 1))) {
+            result.f <<= 1;
+            result.e--;
+        }
+
+        const int shift = 64 - SignificandSize - 2;
+        result.f <<= shift;
+        result.e -= shift;
+        return result;
+    }
+
+    // The boundaries are the midpoints between the number and its neighbours
+    // which delimit the range of digits that read back as the same number.
+    void boundaries(DiyFp& minus, DiyFp& plus) const
+    {
+        plus = DiyFp((f << 1) + 1, e - 1).normalizeBoundary();
+
+        minus = f == HiddenBit
+            ? DiyFp((f << 2) - 1, e - 2)
+            : DiyFp((f << 1) - 1, e - 1);
+
+        minus.f <<= minus.e - plus.e;
+        minus.e = plus.e;
+    }
+
+    static constexpr int SignificandSize = 52;
+    static constexpr int ExponentBias = 0x3FF + SignificandSize;
+    static constexpr int MinExponent = -ExponentBias;
+    static constexpr uint64_t ExponentMask = 0x7FF0000000000000ULL;
+    static constexpr uint64_t SignificandMask = 0x000FFFFFFFFFFFFFULL;
+    static constexpr uint64_t HiddenBit = 0x0010000000000000ULL;
+
+    uint64_t f;
+    int e;
+};
+
+// Normalized 10^k for k = -348 + 8i.
+const uint64_t cachedPowersF[] = {
+    0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+    0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+    0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+    0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+    0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+    0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+    0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+    0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+    0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+    0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+    0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+    0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+    0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+    0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+    0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+    0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+    0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+    0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+    0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+    0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+    0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+    0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+    0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+    0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+    0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+    0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+    0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+    0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+    0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL,
+};
+
+const int16_t cachedPowersE[] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+    -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+    -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+    -422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+    -157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+    109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+    641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+    907, 933, 960, 986, 1013, 1039, 1066,
+};
+
+// Returns c_k = 10^-K such that w * c_k lands in the digit generation range.
+DiyFp cachedPower(int e, int& K)
+{
+    double dk = (-61 - e) * 0.30102999566398114 + 347;
+    int k = static_cast<int>(dk);
+    if (dk - k > 0.0) k++;
+
+    unsigned index = static_cast<unsigned>((k >> 3) + 1);
+    K = -(-348 + static_cast<int>(index << 3));
+
+    return DiyFp(cachedPowersF[index], cachedPowersE[index]);
+}
+
+const uint64_t powersOf10[] = {
+    1ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL,
+    1000000000000000000ULL,
+    10000000000000000000ULL,
+};
+
+int countDigits(uint32_t n)
+{
+    int count = 1;
+    while (n >= 10) { n /= 10; ++count; }
+    return count;
+}
+
+// Walks the last digit down towards w as long as we stay within the boundaries.
+void grisuRound(
+        char* buffer, int len,
+        uint64_t delta, uint64_t rest, uint64_t tenKappa, uint64_t distance)
+{
+    while (rest < distance && delta - rest >= tenKappa &&
+            (rest + tenKappa < distance ||
+                distance - rest > rest + tenKappa - distance))
+    {
+        buffer[len - 1]--;
+        rest += tenKappa;
+    }
+}
+
+void digitGen(
+        const DiyFp& W, const DiyFp& Mp, uint64_t delta,
+        char* buffer, int& len, int& K)
+{
+    const DiyFp one(uint64_t(1) << -Mp.e, Mp.e);
+    const DiyFp distance = Mp - W;
+
+    uint32_t p1 = static_cast<uint32_t>(Mp.f >> -one.e);
+    uint64_t p2 = Mp.f & (one.f - 1);
+    int kappa = countDigits(p1);
+    len = 0;
+
+    while (kappa > 0) {
+        uint32_t divisor = powersOf10[kappa - 1];
+        uint32_t digit = p1 / divisor;
+        p1 %= divisor;
+
+        if (digit || len) buffer[len++] = '0' + digit;
+        kappa--;
+
+        uint64_t rest = (static_cast<uint64_t>(p1) << -one.e) + p2;
+        if (rest <= delta) {
+            K += kappa;
+            grisuRound(buffer, len, delta, rest,
+                    powersOf10[kappa] << -one.e, distance.f);
+            return;
+        }
+    }
+
+    for (;;) {
+        p2 *= 10;
+        delta *= 10;
+
+        char digit = static_cast<char>(p2 >> -one.e);
+        if (digit || len) buffer[len++] = '0' + digit;
+
+        p2 &= one.f - 1;
+        kappa--;
+
+        if (p2 < delta) {
+            K += kappa;
+            int index = -kappa;
+            grisuRound(buffer, len, delta, p2, one.f,
+                    distance.f * (index < 20 ? powersOf10[index] : 0));
+            return;
+        }
+    }
+}
+
+// Generates the digits of a strictly positive value such that the value is
+// digits * 10^K.
+void grisu2(double value, char* buffer, int& len, int& K)
+{
+    const DiyFp v(value);
+    DiyFp minus, plus;
+    v.boundaries(minus, plus);
+
+    const DiyFp c_k = cachedPower(plus.e, K);
+    const DiyFp W = v.normalize() * c_k;
+    DiyFp Wp = plus * c_k;
+    DiyFp Wm = minus * c_k;
+
+    // Shrink the range to account for the imprecision of the multiplication.
+    Wm.f++;
+    Wp.f--;
+
+    digitGen(W, Wp, Wp.f - Wm.f, buffer, len, K);
+}
+
+char* writeExponent(int K, char* buffer)
+{
+    if (K < 0) {
+        *buffer++ = '-';
+        K = -K;
+    }
+
+    if (K >= 100) {
+        *buffer++ = '0' + K / 100;
+        K %= 100;
+        *buffer++ = '0' + K / 10;
+        *buffer++ = '0' + K % 10;
+    }
+    else if (K >= 10) {
+        *buffer++ = '0' + K / 10;
+        *buffer++ = '0' + K % 10;
+    }
+    else *buffer++ = '0' + K;
+
+    return buffer;
+}
+
+// Lays out the digits * 10^k using the same rules as javascript: plain
+// notation for exponents in [-6, 21) and scientific notation otherwise.
+char* prettify(char* buffer, int len, int k)
+{
+    const int kk = len + k; // 10^(kk - 1) <= value < 10^kk
+
+    // 1234e7 -> 12340000000.0
+    if (k >= 0 && kk <= 21) {
+        for (int i = len; i < kk; i++) buffer[i] = '0';
+        buffer[kk] = '.';
+        buffer[kk + 1] = '0';
+        return buffer + kk + 2;
+    }
+
+    // 1234e-2 -> 12.34
+    if (kk > 0 && kk <= 21) {
+        std::memmove(buffer + kk + 1, buffer + kk, len - kk);
+        buffer[kk] = '.';
+        return buffer + len + 1;
+    }
+
+    // 1234e-6 -> 0.001234
+    if (kk > -6 && kk <= 0) {
+        const int offset = 2 - kk;
+        std::memmove(buffer + offset, buffer, len);
+        buffer[0] = '0';
+        buffer[1] = '.';
+        for (int i = 2; i < offset; i++) buffer[i] = '0';
+        return buffer + len + offset;
+    }
+
+    // 1e30
+    if (len == 1) {
+        buffer[1] = 'e';
+        return writeExponent(kk - 1, buffer + 2);
+    }
+
+    // 1234e30 -> 1.234e33
+    std::memmove(buffer + 2, buffer + 1, len - 1);
+    buffer[1] = '.';
+    buffer[len + 1] = 'e';
+    return writeExponent(kk - 1, buffer + len + 2);
+}
+
+} // namespace anonymous
+
+
+/******************************************************************************/
+/* FORMAT FLOAT                                                               */
+/******************************************************************************/
+
+size_t formatFloat(double value, char* buffer)
+{
+    if (!std::isfinite(value)) {
+        std::memcpy(buffer, "null", 4);
+        return 4;
+    }
+
+    char* it = buffer;
+    if (std::signbit(value)) {
+        *it++ = '-';
+        value = -value;
+    }
+
+    if (value == 0.0) {
+        std::memcpy(it, "0.0", 3);
+        return it + 3 - buffer;
+    }
+
+    int len, K;
+    grisu2(value, it, len, K);
+    return prettify(it, len, K) - buffer;
+}
+
+} // namespace json
+} // namespace reflect
@@ -0,0 +1,46 @@
+/* number.h                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   Allocation-free number parsing and formatting for json.
+
+   Floats are parsed exactly with a fast path for the common case of short
+   mantissas and small exponents, falling back on strtod for everything else.
+   They are printed using Grisu2 which always round-trips and almost always
+   yields the shortest representation.
+*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace reflect {
+namespace json {
+
+/******************************************************************************/
+/* NUMBER                                                                     */
+/******************************************************************************/
+
+// Large enough to hold any formatted integer or float.
+enum { NumberBufferSize = 32 };
+
+// The buffer doesn't need to be null terminated. Like std::stol, anything
+// past the integral part is ignored when parsing integers.
+long parseInt(const char* first, size_t len);
+unsigned long parseUInt(const char* first, size_t len);
+
+// Returns false instead of raising an error if the integer is invalid or out
+// of range.
+bool parseInt(const char* first, size_t len, long& value);
+bool parseUInt(const char* first, size_t len, unsigned long& value);
+double parseFloat(const char* first, size_t len);
+
+// Write the number in the buffer without a terminating null and return the
+// number of characters written. Floats always contain a '.' or an exponent so
+// that they're read back as floats and non-finite floats are written as null.
+size_t formatInt(long value, char* buffer);
+size_t formatUInt(unsigned long value, char* buffer);
+size_t formatFloat(double value, char* buffer);
+
+} // namespace json
+} // namespace reflect
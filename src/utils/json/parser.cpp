@@ -6,7 +6,9 @@
 */
 
 #include "parser.h"
-#include "token.h"
+#include "sax.h"
+#include "decoder.h"
+#include "file.h"
 #include "types/primitives.h"
 #include "types/std/string.h"
 #include "types/reflect/type.h"
@@ -23,12 +25,13 @@ namespace json {
 
 namespace {
 
-const Type* getValueType(Value& value)
+const Type* getValueType(const Value& value)
 {
-    return value.type()->call<const Type*>("valueType");
+    static const Symbol fn("valueType");
+    return value.type()->call<const Type*>(fn);
 }
 
-const Type* getFieldType(Value& value, const std::string& field)
+const Type* getFieldType(const Value& value, const std::string& field)
 {
     return value.type()->fieldType(field);
 }
@@ -40,167 +43,304 @@ const Type* getFieldType(Value& value, const std::string& field)
 /* PARSER                                                                     */
 /******************************************************************************/
 
-void parseInto(Value& value, Token token, std::istream& json);
-
+namespace {
 
-void parseNull(Value& value)
+void parseNull(Value& value, BufferContext& json)
 {
-    if (value.is("pointer"))
+    if (value.is(Trait::Pointer))
         value.assign(value.type()->construct());
 
     else {
-        reflectError("can't assign null to non-pointer type <%s>",
+        json.fail("can't assign null to non-pointer type <%s>",
                 value.typeId());
     }
 }
 
-void parseBool(Value& value, const Token& token)
+void parseBool(Value& value, bool token, BufferContext& json)
 {
-    if (value.is("bool"))
-        value.assign(token.boolValue());
+    if (value.is(Trait::Bool))
+        value.assign(token);
 
     else {
-        reflectError("can't assign <%d> to non-bool type <%s>",
-                token.boolValue(), value.typeId());
+        json.fail("can't assign <%d> to non-bool type <%s>",
+                token, value.typeId());
     }
 }
 
-void parseNumber(Value& value, const Token& token)
+void parseNumber(Value& value, const Token& token, BufferContext& json)
 {
-    if (value.is("integer"))
-        value.assign(token.intValue());
+    if (value.is(Trait::Integer)) {
+        long number;
+        if (token.intValue(number)) value.assign(number);
+        else json.fail("integer out of range <%s>", token.stringValue());
+    }
 
-    else if (value.is("float"))
+    else if (value.is(Trait::Float))
         value.assign(token.floatValue());
 
     else {
-        reflectError("can't assign <%s> to non-number type <%s>",
+        json.fail("can't assign <%s> to non-number type <%s>",
                 token.stringValue(), value.typeId());
     }
 }
 
-void parseString(Value& value, const Token& token)
+void parseString(Value& value, const Token& token, BufferContext& json)
 {
-    if (value.is("string"))
+    if (value.is(Trait::String))
         value.assign(token.stringValue());
 
     else {
-        reflectError("can't assign <%s> to non-string type <%s>",
+        json.fail("can't assign <%s> to non-string type <%s>",
                 token.stringValue(), value.typeId());
     }
 }
 
-void parseArray(Value& value, std::istream& json)
+
+/******************************************************************************/
+/* VALUE HANDLER                                                              */
+/******************************************************************************/
+
+/** Materializes the events of the reader into a Value.
+
+    Every array and object being filled is kept on a stack. A value is parsed
+    into a freshly constructed item which is moved into the container on top
+    of the stack once complete. The root value is parsed into directly.
+
+    Errors fail the context which stops the reader from sending any further
+    events.
+ */
+struct ValueHandler : public Handler
 {
-    if (!value.is("list")) {
-        reflectError("can't assign array to non-array type <%s>",
-                value.typeId());
-    }
+    ValueHandler(Value& root, BufferContext& json) : root(root), json(json) {}
 
-    auto type = getValueType(value);
+    void onObjectStart()
+    {
+        Value value;
+        if (!slot(value)) return;
+
+        if (value.is(Trait::Primitive)
+                || value.is(Trait::List)
+                || value.is(Trait::String))
+        {
+            return json.fail("can't assign object to non-object type <%s>",
+                    value.typeId());
+        }
 
-    Token token = nextToken(json);
-    if (token.type() == Token::ArrayEnd) return;
+        bool isMap = value.is(Trait::Map);
+        push(value, isMap ? Frame::Map : Frame::Object);
+    }
 
-    while (json) {
+    void onKey(const Token& token) { stack.back().key = token.stringValue(); }
+    void onObjectEnd() { pop(); }
 
-        Value item = type->construct();
-        parseInto(item, token, json);
-        value.call<void>("push_back", item.rvalue());
+    void onArrayStart()
+    {
+        Value value;
+        if (!slot(value)) return;
 
-        token = nextToken(json);
-        if (token.type() == Token::Separator) {
-            token = nextToken(json);
-            continue;
+        if (!value.is(Trait::List)) {
+            return json.fail("can't assign array to non-array type <%s>",
+                    value.typeId());
         }
 
-        expectToken(token, Token::ArrayEnd);
-        return;
+        push(value, Frame::List);
     }
 
-    reflectError("unexpected end of array");
-}
+    void onArrayEnd() { pop(); }
 
-void parseObject(Value& value, std::istream& json)
-{
-    if (value.is("primitive") || value.is("list") || value.is("string")) {
-        reflectError("can't assign object to non-object type <%s>",
-                value.typeId());
+    void onNull()
+    {
+        Value value;
+        if (!slot(value)) return;
+
+        parseNull(value, json);
+        commit(value);
     }
 
-    Token token = nextToken(json);
-    if (token.type() == Token::ObjectEnd) return;
+    void onBool(bool token)
+    {
+        Value value;
+        if (!slot(value)) return;
 
-    bool isMap = value.is("map");
-    const Type* tValue = nullptr;
-    if (isMap) tValue = getValueType(value);
+        parseBool(value, token, json);
+        commit(value);
+    }
+
+    void onNumber(const Token& token)
+    {
+        Value value;
+        if (!slot(value)) return;
+
+        parseNumber(value, token, json);
+        commit(value);
+    }
+
+    void onString(const Token& token)
+    {
+        Value value;
+        if (!slot(value)) return;
+
+        parseString(value, token, json);
+        commit(value);
+    }
+
+private:
 
-    while (json) {
+    struct Frame
+    {
+        enum Kind { Object, Map, List };
 
-        expectToken(token, Token::String);
-        const std::string key = token.stringValue();
+        Value value;
+        Kind kind;
+        const Type* valueType; // null for objects.
+        std::string key;
+    };
 
-        expectToken(nextToken(json), Token::KeySeparator);
+    // Sets the value that the current event should be parsed into.
+    bool slot(Value& value)
+    {
+        if (stack.empty()) {
+            value = root;
+            return true;
+        }
 
-        const Type* type = isMap ? tValue : getFieldType(value, key);
-        Value item = type->construct();
-        parseInto(item, json);
+        Frame& top = stack.back();
+        const Type* type = top.valueType;
 
-        if (isMap) value[key].assign(item.rvalue());
-        else value.set(key, item.rvalue());
+        if (!type) {
+            if (!top.value.type()->hasField(top.key)) {
+                json.fail("<%s> doesn't have a field <%s>",
+                        top.value.typeId(), top.key);
+                return false;
+            }
 
-        token = nextToken(json);
-        if (token.type() == Token::Separator) {
-            token = nextToken(json);
-            continue;
+            type = getFieldType(top.value, top.key);
         }
 
-        expectToken(token, Token::ObjectEnd);
-        return;
+        value = type->construct();
+        return true;
     }
 
-    reflectError("unexpected end of object");
-}
+    void commit(Value& item)
+    {
+        static const Symbol pushBack("push_back");
 
+        if (stack.empty() || json.failed()) return;
 
-void parseInto(Value& value, Token token, std::istream& json)
-{
-    switch (token.type())
+        Frame& top = stack.back();
+        const std::string& key = top.key;
+
+        switch (top.kind)
+        {
+        case Frame::Object: top.value.set(key, item.rvalue()); break;
+        case Frame::Map: top.value[key].assign(item.rvalue()); break;
+        case Frame::List: top.value.call<void>(pushBack, item.rvalue()); break;
+        }
+    }
+
+    void push(Value& value, Frame::Kind kind)
     {
-    case Token::Null: parseNull(value); break;
-    case Token::Bool: parseBool(value, token); break;
-    case Token::Number: parseNumber(value, token); break;
-    case Token::String: parseString(value, token); break;
-    case Token::ArrayStart: parseArray(value, json); break;
-    case Token::ObjectStart: parseObject(value, json); break;
-
-    default: reflectError("unexpected token <%s>", print(token.type()));
+        const Type* valueType =
+            kind == Frame::Object ? nullptr : getValueType(value);
+
+        stack.push_back(Frame{ value, kind, valueType, std::string() });
     }
+
+    void pop()
+    {
+        Value value = std::move(stack.back().value);
+        stack.pop_back();
+        commit(value);
+    }
+
+    Value& root;
+    BufferContext& json;
+    std::vector<Frame> stack;
+};
+
+} // namespace anonymous
+
+
+void parseGeneric(const Value& value, const Token& token, BufferContext& json)
+{
+    Value root = value;
+    ValueHandler handler(root, json);
+    read(token, json, handler);
 }
 
+void parseInto(Value& value, BufferContext& json)
+{
+    decoder(value.type()).decode(value, nextToken(json), json);
+}
 
-void parseInto(Value& value, std::istream& json)
+void parseInto(Value& value, const char* json, size_t len)
 {
-    parseInto(value, nextToken(json), json);
+    BufferContext context(json, len);
+    parseInto(value, context);
+
+    if (context.failed()) reflectError("%s", context.error().print());
 }
 
 void parseInto(Value& value, const std::string& json)
 {
-    std::stringstream ss(json);
-    parseInto(value, ss);
+    parseInto(value, json.data(), json.size());
 }
 
-Value parse(const Type* type, std::istream& json)
+bool parseInto(
+        Value& value, const char* json, size_t len, std::vector<Error>& errors)
+{
+    BufferContext context(json, len);
+
+    // Only reachable when the reflected types raise their own errors with
+    // exceptions enabled; the parser itself fails the context instead.
+    try { parseInto(value, context); }
+    catch (const ReflectError& caught) { context.fail(caught.what()); }
+
+    if (!context.failed()) return true;
+
+    errors.push_back(std::move(context.error()));
+    return false;
+}
+
+bool parseInto(
+        Value& value, const std::string& json, std::vector<Error>& errors)
+{
+    return parseInto(value, json.data(), json.size(), errors);
+}
+
+void parseInto(Value& value, std::istream& json)
+{
+    parseInto(value, readAll(json));
+}
+
+void parseFileInto(Value& value, const std::string& path)
+{
+    MappedFile file(path);
+    parseInto(value, file.data(), file.size());
+}
+
+Value parse(const Type* type, const char* json, size_t len)
 {
     Value value = type->construct();
-    parseInto(value, json);
+    parseInto(value, json, len);
     return value;
 }
 
 Value parse(const Type* type, const std::string& json)
 {
-    std::stringstream ss(json);
-    return parse(type, ss);
+    return parse(type, json.data(), json.size());
+}
+
+Value parse(const Type* type, std::istream& json)
+{
+    return parse(type, readAll(json));
+}
+
+Value parseFile(const Type* type, const std::string& path)
+{
+    Value value = type->construct();
+    parseFileInto(value, path);
+    return value;
 }
 
 } // namespace json
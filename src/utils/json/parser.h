@@ -8,6 +8,7 @@
 #pragma once
 
 #include "reflect.h"
+#include "context.h"
 
 namespace reflect {
 namespace json {
@@ -19,6 +20,7 @@ namespace json {
 
 void parseInto(Value& value, std::istream& json);
 void parseInto(Value& value, const std::string& json);
+void parseInto(Value& value, const char* json, size_t len);
 
 template<typename T>
 void parseInto(T& value, std::istream& json)
@@ -34,6 +36,72 @@ void parseInto(T& value, const std::string& json)
     parseInto(v, json);
 }
 
+template<typename T>
+void parseInto(T& value, const char* json, size_t len)
+{
+    Value v(value);
+    parseInto(v, json, len);
+}
+
+
+/******************************************************************************/
+/* PARSE INTO CHECKED                                                         */
+/******************************************************************************/
+
+/** Instead of raising an error, these overloads report malformed input by
+    returning false and adding an error to the list. The error contains the
+    position within the buffer and the json pointer of the value that failed.
+
+    The value is left partially parsed on failure.
+
+    A ReflectError thrown by a reflected function while parsing (a setter
+    rejecting its value for example) is also reported through the list.
+    Errors that abort, because exceptions are disabled where they are raised,
+    can't be reported and still abort.
+ */
+bool parseInto(
+        Value& value, const char* json, size_t len, std::vector<Error>& errors);
+bool parseInto(
+        Value& value, const std::string& json, std::vector<Error>& errors);
+
+template<typename T>
+bool parseInto(T& value, const std::string& json, std::vector<Error>& errors)
+{
+    Value v(value);
+    return parseInto(v, json, errors);
+}
+
+template<typename T>
+bool parseInto(
+        T& value, const char* json, size_t len, std::vector<Error>& errors)
+{
+    Value v(value);
+    return parseInto(v, json, len, errors);
+}
+
+
+/******************************************************************************/
+/* PARSE FILE                                                                 */
+/******************************************************************************/
+
+/** The file is memory mapped and parsed in place. */
+void parseFileInto(Value& value, const std::string& path);
+Value parseFile(const Type* type, const std::string& path);
+
+template<typename T>
+void parseFileInto(T& value, const std::string& path)
+{
+    Value v(value);
+    parseFileInto(v, path);
+}
+
+template<typename T>
+T parseFile(const std::string& path)
+{
+    Value v = parseFile(type<T>(), path);
+    return v.get<T>();
+}
+
 
 /******************************************************************************/
 /* PARSE                                                                      */
@@ -41,6 +109,7 @@ void parseInto(T& value, const std::string& json)
 
 Value parse(const Type* type, std::istream& json);
 Value parse(const Type* type, const std::string& json);
+Value parse(const Type* type, const char* json, size_t len);
 
 template<typename T>
 T parse(std::istream& json)
@@ -56,6 +125,13 @@ T parse(const std::string& json)
     return v.get<T>();
 }
 
+template<typename T>
+T parse(const char* json, size_t len)
+{
+    Value v = parse(type<T>(), json, len);
+    return v.get<T>();
+}
+
 
 } // namespace json
 } // reflect
@@ -6,13 +6,13 @@
 */
 
 #include "printer.h"
+#include "encoder.h"
 #include "token.h"
 #include "types/primitives.h"
 #include "types/std/string.h"
 #include "types/std/vector.h"
 #include "types/reflect/type.h"
 
-#include <sstream>
 
 namespace reflect {
 namespace json {
@@ -23,126 +23,128 @@ namespace {
 /* PRINTER                                                                    */
 /******************************************************************************/
 
+void print(const Value& value, Writer& json, int indent);
 
-void newline(std::ostream& json, int indent)
-{
-    if (indent < 0) return;
-    json << '\n' << std::string(indent * 4, ' ');
-}
-
-void space(std::ostream& json, int indent)
-{
-    if (indent < 0) return;
-    json << ' ';
-}
-
-int inc(int indent) { return indent < 0 ? -1 : (indent + 1); }
-
-
-void print(const Value& value, std::ostream& json, int indent);
-
-void printPointer(const Value& value, std::ostream& json, int indent)
+void printPointer(const Value& value, Writer& json, int indent)
 {
     if (!value) printNull(json);
     else print(*value, json, indent);
 }
 
-void printArray(const Value& value, std::ostream& json, int indent)
+void printArray(const Value& value, Writer& json, int indent)
 {
-    json << '[';
-    size_t n = value.call<size_t>("size");
+    json.put('[');
+    static const Symbol size("size");
+    size_t n = value.call<size_t>(size);
 
     for (size_t i = 0; i < n; ++i) {
-        if (i) json << ',';
+        if (i) json.put(',');
         newline(json, inc(indent));
         print(value[i], json, inc(indent));
     }
 
     if (n) newline(json, indent);
-    json << ']';
+    json.put(']');
 }
 
 
-void printMap(const Value& value, std::ostream& json, int indent)
+void printMap(const Value& value, Writer& json, int indent)
 {
-    json << '{';
+    json.put('{');
     size_t i = 0;
 
-    auto keys = value.call<std::vector<std::string> >("keys");
+    static const Symbol keysFn("keys");
+    auto keys = value.call<std::vector<std::string> >(keysFn);
 
     for (const auto& key : keys) {
-        if (i++) json << ',';
+        if (i++) json.put(',');
         newline(json, inc(indent));
 
         printString(key, json);
 
-        json << ':';
+        json.put(':');
         space(json, indent);
 
         print(value[key], json, inc(indent));
     }
 
     if (i) newline(json, indent);
-    json << '}';
+    json.put('}');
 }
 
-void printObject(const Value& value, std::ostream& json, int indent)
+void printObject(const Value& value, Writer& json, int indent)
 {
-    json << '{';
+    json.put('{');
     size_t i = 0;
 
-    for (const auto& field : value.type()->fields()) {
-        if (!value.type()->hasField(field)) continue;
+    for (const auto& field : value.type()->fieldDescriptors()) {
+        if (!field.getter && !field.hasOffset()) continue;
 
-        if (i++) json << ',';
+        if (i++) json.put(',');
         newline(json, inc(indent));
 
-        printString(field, json);
+        printString(field.name.str(), json);
 
-        json << ':';
+        json.put(':');
         space(json, indent);
 
-        print(value.get<Value>(field), json, inc(indent));
+        print(value.field(field), json, inc(indent));
     }
 
     if (i) newline(json, indent);
-    json << '}';
+    json.put('}');
 }
 
 
-void print(const Value& value, std::ostream& json, int indent)
+void print(const Value& value, Writer& json, int indent)
 {
+    encoder(value.type()).encode(value, json, indent);
+}
+
+} // namespace anonymous
+
+
+void printGeneric(const Value& value, Writer& json, int indent)
+{
+    const Type* type = value.type();
+
     // copy allows for converters to be called.
-    if (value.is("bool")) printBool(value.copy<bool>(), json);
-    else if (value.is("float")) printFloat(value.copy<double>(), json);
-    else if (value.is("integer")) printInteger(value.copy<long>(), json);
-    else if (value.is("string")) printString(value.copy<std::string>(), json);
+    if (type->is(Trait::Bool)) printBool(value.copy<bool>(), json);
+    else if (type->is(Trait::Float)) printFloat(value.copy<double>(), json);
+    else if (type->is(Trait::Integer)) printInteger(value.copy<long>(), json);
+    else if (type->is(Trait::String))
+        printString(value.copy<std::string>(), json);
 
-    else if (value.is("map")) printMap(value, json, indent);
-    else if (value.is("list")) printArray(value, json, indent);
-    else if (value.is("pointer")) printPointer(value, json, indent);
-    else if (!value.is("primitive")) printObject(value, json, indent);
+    else if (type->is(Trait::Map)) printMap(value, json, indent);
+    else if (type->is(Trait::List)) printArray(value, json, indent);
+    else if (type->is(Trait::Pointer)) printPointer(value, json, indent);
+    else if (!type->is(Trait::Primitive)) printObject(value, json, indent);
 
     else reflectError("can't print value");
 }
 
-} // namespace anonymous
-
 
 /******************************************************************************/
 /* INTERFACE                                                                  */
 /******************************************************************************/
 
-void print(const Value& value, std::ostream& json, bool pretty)
+void print(const Value& value, Writer& json, bool pretty)
 {
     print(value, json, pretty ? 0 : -1);
 }
 
-std::string print(Value& value, bool pretty)
+void print(const Value& value, std::ostream& json, bool pretty)
+{
+    StreamWriter writer(json);
+    print(value, writer, pretty);
+    writer.flush();
+}
+
+std::string print(const Value& value, bool pretty)
 {
-    std::stringstream ss;
-    print(value, ss, pretty);
-    return ss.str();
+    StringWriter writer;
+    print(value, writer, pretty);
+    return writer.str();
 }
 
 } // namespace json
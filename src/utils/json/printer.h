@@ -8,6 +8,7 @@
 #pragma once
 
 #include "reflect.h"
+#include "writer.h"
 
 namespace reflect {
 namespace json {
@@ -17,9 +18,16 @@ namespace json {
 /* PRINT                                                                      */
 /******************************************************************************/
 
-std::string print(Value& value, bool pretty = false);
+std::string print(const Value& value, bool pretty = false);
+void print(const Value& value, Writer& json, bool pretty = false);
 void print(const Value& value, std::ostream& json, bool pretty = false);
 
+template<typename T>
+void print(const T& value, Writer& json, bool pretty = false)
+{
+    print(Value(value), json, pretty);
+}
+
 template<typename T>
 void print(const T& value, std::ostream& json, bool pretty = false)
 {
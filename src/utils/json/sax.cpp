@@ -0,0 +1,258 @@
+/* sax.cpp                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   Event based json reader implementation.
+*/
+
+#include "sax.h"
+#include "reflect.h"
+
+namespace reflect {
+namespace json {
+
+/******************************************************************************/
+/* READER                                                                     */
+/******************************************************************************/
+
+namespace {
+
+/** Documents are walked with an explicit stack of the arrays and objects
+    currently open so that deeply nested input can't overflow the call stack.
+
+    On failure, the path of the error is built from the stack. The innermost
+    container only contributes its current key or index if the failure
+    happened while reading one of its values as opposed to its own structure.
+ */
+struct Frame
+{
+    explicit Frame(bool isObject) : isObject(isObject), index(0) {}
+
+    bool isObject;
+    size_t index;
+    std::string key; // Tokens don't outlive the chunk they were read from.
+};
+
+void unwind(BufferContext& json, const std::vector<Frame>& stack, bool inValue)
+{
+    Error& error = json.error();
+
+    for (size_t i = stack.size(); i > 0; --i) {
+        const Frame& frame = stack[i - 1];
+        if (i == stack.size() && !inValue) continue;
+
+        if (frame.isObject) error.prefix(frame.key);
+        else error.prefix(frame.index);
+    }
+}
+
+template<typename Source>
+bool readKey(const Token& token, Frame& frame, Source& source, Handler& handler)
+{
+    BufferContext& json = source.json;
+
+    if (!expectToken(token, Token::String, json)) return false;
+
+    frame.key.assign(token.data(), token.size());
+    handler.onKey(token);
+    if (json.failed()) return false;
+
+    return expectToken(source.next(), Token::KeySeparator, json);
+}
+
+template<typename Source>
+void readValue(Token token, Source& source, Handler& handler)
+{
+    BufferContext& json = source.json;
+    std::vector<Frame> stack;
+
+    while (true) {
+
+        // Reads the value starting at token.
+        switch (token.type())
+        {
+        case Token::Null: handler.onNull(); break;
+        case Token::Bool: handler.onBool(token.boolValue()); break;
+        case Token::Number: handler.onNumber(token); break;
+        case Token::String: handler.onString(token); break;
+
+        case Token::ArrayStart:
+            handler.onArrayStart();
+            if (json.failed()) return unwind(json, stack, true);
+
+            token = source.next();
+            if (token.type() == Token::ArrayEnd) {
+                handler.onArrayEnd();
+                break;
+            }
+
+            stack.emplace_back(false);
+            if (json.failed()) return unwind(json, stack, true);
+            continue;
+
+        case Token::ObjectStart:
+            handler.onObjectStart();
+            if (json.failed()) return unwind(json, stack, true);
+
+            token = source.next();
+            if (token.type() == Token::ObjectEnd) {
+                handler.onObjectEnd();
+                break;
+            }
+
+            stack.emplace_back(true);
+            if (!readKey(token, stack.back(), source, handler))
+                return unwind(json, stack, false);
+
+            token = source.next();
+            if (json.failed()) return unwind(json, stack, true);
+            continue;
+
+        default:
+            json.fail("unexpected token <%s>", print(token.type()));
+        }
+
+        if (json.failed()) return unwind(json, stack, true);
+
+        // The value is complete so close off any container that ends here and
+        // move on to the next value of the innermost one that doesn't.
+        while (!stack.empty()) {
+            Frame& top = stack.back();
+
+            token = source.next();
+            if (token.type() == Token::Separator) {
+                top.index++;
+                token = source.next();
+
+                if (top.isObject) {
+                    if (!readKey(token, top, source, handler))
+                        return unwind(json, stack, false);
+                    token = source.next();
+                }
+
+                if (json.failed()) return unwind(json, stack, true);
+                break;
+            }
+
+            Token::Type end = top.isObject ? Token::ObjectEnd : Token::ArrayEnd;
+            if (!expectToken(token, end, json))
+                return unwind(json, stack, false);
+
+            if (top.isObject) handler.onObjectEnd();
+            else handler.onArrayEnd();
+
+            stack.pop_back();
+            if (json.failed()) return unwind(json, stack, true);
+        }
+
+        if (stack.empty()) return;
+    }
+}
+
+
+/******************************************************************************/
+/* SOURCES                                                                    */
+/******************************************************************************/
+
+struct BufferSource
+{
+    explicit BufferSource(BufferContext& json) : json(json) {}
+
+    Token next() { return nextToken(json); }
+
+    BufferContext& json;
+};
+
+/** Reads a stream one chunk at a time. Tokens are first scanned on a scratch
+    context since one that fails or that runs into the end of the chunk might
+    simply continue in the next chunk. The unread tail of the buffer is then
+    kept and the next chunk appended to it before trying again.
+ */
+struct StreamSource
+{
+    enum { ChunkSize = 64 * 1024 };
+
+    explicit StreamSource(std::istream& stream) :
+        stream(stream), json(buffer), eof(false)
+    {}
+
+    Token next()
+    {
+        while (!eof && !json.failed()) {
+            size_t left = json.end() - json.cursor();
+            BufferContext probe(json.cursor(), left);
+
+            Token token = nextToken(probe);
+            if (!probe.failed() && probe) {
+                json.seek(probe.cursor());
+                return token;
+            }
+
+            refill();
+        }
+
+        return nextToken(json);
+    }
+
+    void refill()
+    {
+        Pos base = json.pos();
+        buffer.erase(0, json.tell());
+
+        // Growing the reads geometrically keeps very large tokens from being
+        // rescanned once per chunk.
+        size_t size = buffer.size();
+        size_t chunk = std::max<size_t>(ChunkSize, size);
+
+        buffer.resize(size + chunk);
+        stream.read(&buffer[size], chunk);
+        buffer.resize(size + stream.gcount());
+
+        eof = !stream.gcount();
+        json.reset(buffer.data(), buffer.size(), base);
+    }
+
+    std::istream& stream;
+    std::string buffer;
+    BufferContext json;
+    bool eof;
+};
+
+} // namespace anonymous
+
+
+void read(const Token& token, BufferContext& json, Handler& handler)
+{
+    BufferSource source(json);
+    readValue(token, source, handler);
+}
+
+void read(BufferContext& json, Handler& handler)
+{
+    read(nextToken(json), json, handler);
+}
+
+void read(const char* json, size_t len, Handler& handler)
+{
+    BufferContext context(json, len);
+    read(context, handler);
+
+    if (context.failed()) reflectError("%s", context.error().print());
+}
+
+void read(const std::string& json, Handler& handler)
+{
+    read(json.data(), json.size(), handler);
+}
+
+void read(std::istream& json, Handler& handler)
+{
+    StreamSource source(json);
+    readValue(source.next(), source, handler);
+
+    if (source.json.failed())
+        reflectError("%s", source.json.error().print());
+}
+
+} // namespace json
+} // namespace reflect
@@ -0,0 +1,65 @@
+/* sax.h                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   Event based json reader.
+
+   The reader walks the document and pushes an event to the handler for every
+   value it encounters without building anything along the way. This makes it
+   possible to filter, project or route a document without materializing it.
+
+   Tokens passed to the handler refer to the input buffer and are only valid
+   for the duration of the callback.
+*/
+
+#pragma once
+
+#include "token.h"
+
+#include <istream>
+
+namespace reflect {
+namespace json {
+
+/******************************************************************************/
+/* HANDLER                                                                    */
+/******************************************************************************/
+
+struct Handler
+{
+    virtual ~Handler() {}
+
+    virtual void onObjectStart() {}
+    virtual void onKey(const Token&) {}
+    virtual void onObjectEnd() {}
+
+    virtual void onArrayStart() {}
+    virtual void onArrayEnd() {}
+
+    virtual void onNull() {}
+    virtual void onBool(bool) {}
+    virtual void onNumber(const Token&) {}
+    virtual void onString(const Token&) {}
+};
+
+
+/******************************************************************************/
+/* READ                                                                       */
+/******************************************************************************/
+
+/** Reads a single value from the context and leaves the cursor right after
+    it. Malformed input fails the context and no further events are sent to
+    the handler.
+ */
+void read(BufferContext& json, Handler& handler);
+
+// Same as above but the first token of the value was already read.
+void read(const Token& token, BufferContext& json, Handler& handler);
+
+// Errors are raised as usual.
+void read(const char* json, size_t len, Handler& handler);
+void read(const std::string& json, Handler& handler);
+void read(std::istream& json, Handler& handler);
+
+} // namespace json
+} // namespace reflect
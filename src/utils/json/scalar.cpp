@@ -0,0 +1,75 @@
+/* scalar.cpp                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   Scalar representation implementation.
+*/
+
+#include "scalar.h"
+#include "types/primitives.h"
+#include "types/std/string.h"
+
+namespace reflect {
+namespace json {
+
+/******************************************************************************/
+/* SCALAR                                                                     */
+/******************************************************************************/
+
+namespace {
+
+struct ScalarId
+{
+    std::string id;
+    Scalar scalar;
+};
+
+template<typename T>
+ScalarId scalarId()
+{
+    Scalar::Kind kind =
+        std::is_same<T, bool>::value ? Scalar::Bool :
+        std::is_floating_point<T>::value ? Scalar::Float :
+        std::is_signed<T>::value ? Scalar::Int : Scalar::UInt;
+
+    // Only uses the id of the type to avoid loading types that are never
+    // encoded or decoded.
+    return { typeId<T>(), { kind, sizeof(T) } };
+}
+
+const std::vector<ScalarId>& scalarIds()
+{
+    static const std::vector<ScalarId> table = {
+        scalarId<bool>(),
+        scalarId<char>(),
+        scalarId<signed char>(),
+        scalarId<unsigned char>(),
+        scalarId<short int>(),
+        scalarId<unsigned short int>(),
+        scalarId<int>(),
+        scalarId<unsigned int>(),
+        scalarId<long int>(),
+        scalarId<unsigned long int>(),
+        scalarId<long long int>(),
+        scalarId<unsigned long long int>(),
+        scalarId<float>(),
+        scalarId<double>(),
+        { typeId<std::string>(), { Scalar::String, sizeof(std::string) } },
+    };
+    return table;
+}
+
+} // namespace anonymous
+
+
+Scalar scalar(const Type* type)
+{
+    for (const auto& entry : scalarIds()) {
+        if (type->id() == entry.id) return entry.scalar;
+    }
+
+    return { Scalar::None, 0 };
+}
+
+} // namespace json
+} // namespace reflect
@@ -0,0 +1,32 @@
+/* scalar.h                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   Concrete representation of the scalar types used by the compiled encoders
+   and decoders.
+*/
+
+#pragma once
+
+#include "reflect.h"
+
+namespace reflect {
+namespace json {
+
+/******************************************************************************/
+/* SCALAR                                                                     */
+/******************************************************************************/
+
+struct Scalar
+{
+    enum Kind { None, Bool, Int, UInt, Float, String };
+
+    Kind kind;
+    size_t size;
+};
+
+// Returns None if the type isn't one of the known primitives or std::string.
+Scalar scalar(const Type* type);
+
+} // namespace json
+} // namespace reflect
@@ -0,0 +1,198 @@
+/* scan.cpp                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   Vectorized character scanning implementation.
+*/
+
+#include "scan.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#  define REFLECT_JSON_X86 1
+#  include <immintrin.h>
+#else
+#  define REFLECT_JSON_X86 0
+#endif
+
+namespace reflect {
+namespace json {
+
+/******************************************************************************/
+/* SCALAR                                                                     */
+/******************************************************************************/
+
+namespace {
+
+bool isSpaceChar(char c)
+{
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+const char* skipSpaceScalar(const char* it, const char* end)
+{
+    while (it < end && isSpaceChar(*it)) ++it;
+    return it;
+}
+
+const char* findQuoteScalar(const char* it, const char* end)
+{
+    while (it < end && *it != '"' && *it != '\\') ++it;
+    return it;
+}
+
+} // namespace anonymous
+
+const Scanner* scalarScanner()
+{
+    static const Scanner scanner =
+        { &skipSpaceScalar, &findQuoteScalar, "scalar" };
+    return &scanner;
+}
+
+
+/******************************************************************************/
+/* SSE2                                                                       */
+/******************************************************************************/
+
+#if REFLECT_JSON_X86
+
+namespace {
+
+// SSE2 is part of the x86-64 baseline so no target attribute is required.
+
+__m128i spaceMask16(__m128i chunk)
+{
+    __m128i mask = _mm_cmpeq_epi8(chunk, _mm_set1_epi8(' '));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t')));
+    return _mm_or_si128(mask, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')));
+}
+
+const char* skipSpaceSse2(const char* it, const char* end)
+{
+    for (; end - it >= 16; it += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        unsigned mask = ~_mm_movemask_epi8(spaceMask16(chunk)) & 0xFFFF;
+        if (mask) return it + __builtin_ctz(mask);
+    }
+
+    return skipSpaceScalar(it, end);
+}
+
+const char* findQuoteSse2(const char* it, const char* end)
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i escape = _mm_set1_epi8('\\');
+
+    for (; end - it >= 16; it += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        __m128i match = _mm_or_si128(
+                _mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, escape));
+
+        unsigned mask = _mm_movemask_epi8(match);
+        if (mask) return it + __builtin_ctz(mask);
+    }
+
+    return findQuoteScalar(it, end);
+}
+
+} // namespace anonymous
+
+const Scanner* sse2Scanner()
+{
+    static const Scanner scanner = { &skipSpaceSse2, &findQuoteSse2, "sse2" };
+    return &scanner;
+}
+
+#else
+
+const Scanner* sse2Scanner() { return nullptr; }
+
+#endif // REFLECT_JSON_X86
+
+
+/******************************************************************************/
+/* AVX2                                                                       */
+/******************************************************************************/
+
+#if REFLECT_JSON_X86
+
+namespace {
+
+__attribute__((target("avx2")))
+__m256i spaceMask32(__m256i chunk)
+{
+    __m256i space = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' '));
+    __m256i nl = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n'));
+    __m256i tab = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t'));
+    __m256i cr = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r'));
+
+    __m256i mask = _mm256_or_si256(space, nl);
+    return _mm256_or_si256(mask, _mm256_or_si256(tab, cr));
+}
+
+__attribute__((target("avx2")))
+const char* skipSpaceAvx2(const char* it, const char* end)
+{
+    for (; end - it >= 32; it += 32) {
+        auto ptr = reinterpret_cast<const __m256i*>(it);
+        __m256i chunk = _mm256_loadu_si256(ptr);
+        unsigned mask = ~unsigned(_mm256_movemask_epi8(spaceMask32(chunk)));
+        if (mask) return it + __builtin_ctz(mask);
+    }
+
+    return skipSpaceSse2(it, end);
+}
+
+__attribute__((target("avx2")))
+const char* findQuoteAvx2(const char* it, const char* end)
+{
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i escape = _mm256_set1_epi8('\\');
+
+    for (; end - it >= 32; it += 32) {
+        auto ptr = reinterpret_cast<const __m256i*>(it);
+        __m256i chunk = _mm256_loadu_si256(ptr);
+        __m256i match = _mm256_or_si256(
+                _mm256_cmpeq_epi8(chunk, quote),
+                _mm256_cmpeq_epi8(chunk, escape));
+
+        unsigned mask = _mm256_movemask_epi8(match);
+        if (mask) return it + __builtin_ctz(mask);
+    }
+
+    return findQuoteSse2(it, end);
+}
+
+} // namespace anonymous
+
+const Scanner* avx2Scanner()
+{
+    static const Scanner scanner = { &skipSpaceAvx2, &findQuoteAvx2, "avx2" };
+    return __builtin_cpu_supports("avx2") ? &scanner : nullptr;
+}
+
+#else
+
+const Scanner* avx2Scanner() { return nullptr; }
+
+#endif // REFLECT_JSON_X86
+
+
+/******************************************************************************/
+/* DISPATCH                                                                   */
+/******************************************************************************/
+
+const Scanner& scanner()
+{
+    static const Scanner* best = [] {
+        if (const Scanner* scanner = avx2Scanner()) return scanner;
+        if (const Scanner* scanner = sse2Scanner()) return scanner;
+        return scalarScanner();
+    }();
+
+    return *best;
+}
+
+} // namespace json
+} // namespace reflect
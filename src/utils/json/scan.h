@@ -0,0 +1,43 @@
+/* scan.h                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   Vectorized character scanning for the json tokenizer.
+
+   These are the loops where the tokenizer spends most of its time on large
+   documents: skipping over whitespace and looking for the end of strings. Each
+   scanner is implemented for AVX2, SSE2 and as a plain scalar loop and the
+   best available implementation is picked at runtime.
+*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace reflect {
+namespace json {
+
+/******************************************************************************/
+/* SCANNER                                                                    */
+/******************************************************************************/
+
+struct Scanner
+{
+    // Returns the first non-whitespace character in [it, end) or end.
+    const char* (*skipSpace)(const char* it, const char* end);
+
+    // Returns the first quote or backslash in [it, end) or end.
+    const char* (*findQuote)(const char* it, const char* end);
+
+    const char* name;
+};
+
+const Scanner& scanner();
+
+// Implementations exposed for testing; null if not supported by the cpu.
+const Scanner* scalarScanner();
+const Scanner* sse2Scanner();
+const Scanner* avx2Scanner();
+
+} // namespace json
+} // namespace reflect
@@ -6,11 +6,12 @@
 */
 
 #include "token.h"
+#include "scan.h"
+#include "number.h"
 #include "reflect.h"
 
-#include <array>
+#include <cstring>
 #include <sstream>
-#include <ctype.h>
 
 namespace reflect {
 namespace json {
@@ -20,43 +21,54 @@ namespace json {
 /******************************************************************************/
 
 Token::
-Token(Type type, std::string value) :
-    type_(type), value_(std::move(value))
+Token(Type type, bool value) :
+    type_(type), bool_(value), ptr_(nullptr), len_(0)
 {}
 
-
 Token::
-Token(Type type, bool value) :
-    type_(type), value_(value ? "t" : "")
+Token(Type type, const char* ptr, size_t len) :
+    type_(type), bool_(false), ptr_(ptr), len_(len)
 {}
 
-
-std::string
 Token::
-stringValue() const
-{
-    return value_;
-}
+Token(Type type, std::string value) :
+    type_(type), bool_(false), ptr_(nullptr), len_(0), value_(std::move(value))
+{}
+
 
 double
 Token::
 floatValue() const
 {
-    return std::stod(value_);
+    return parseFloat(data(), size());
 }
 
 long
 Token::
 intValue() const
 {
-    return std::stol(value_);
+    return parseInt(data(), size());
+}
+
+unsigned long
+Token::
+uintValue() const
+{
+    return parseUInt(data(), size());
 }
 
 bool
 Token::
-boolValue() const
+intValue(long& value) const
 {
-    return !value_.empty();
+    return parseInt(data(), size(), value);
+}
+
+bool
+Token::
+uintValue(unsigned long& value) const
+{
+    return parseUInt(data(), size(), value);
 }
 
 
@@ -91,7 +103,8 @@ print() const
     std::stringstream ss;
 
     ss << "<Token " << reflect::json::print(type_);
-    if (!value_.empty()) ss << ": " << value_;
+    if (type_ == Bool) ss << ": " << (bool_ ? "true" : "false");
+    else if (size()) ss << ": " << stringValue();
     ss << ">";
 
     return ss.str();
@@ -104,50 +117,105 @@ print() const
 
 namespace {
 
-char nextChar(std::istream& json)
+bool isSpace(char c)
 {
-    while (json) {
-        char c = json.get();
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
 
-        if (std::isspace(c)) continue;
+bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+char nextChar(BufferContext& json)
+{
+    const char* it = json.cursor();
+    const char* end = json.end();
+
+    while (it < end) {
+
+        // Tokens are usually separated by at most a single space so the
+        // vectorized scan is only worth it for longer runs of whitespace.
+        if (isSpace(*it)) {
+            it = scanner().skipSpace(it + 1, end);
+            if (it == end) break;
+        }
+
+        char c = *it++;
 
         // Skip comments.
-        if (c == '/' && json.peek() == '/') {
-            while (json && (c = json.get()) != '\n') continue;
+        if (c == '/' && it < end && *it == '/') {
+            const void* eol = std::memchr(it, '\n', end - it);
+            it = eol ? static_cast<const char*>(eol) : end;
             continue;
         }
 
+        json.seek(it);
         return c;
     }
 
+    json.seek(end);
     return '\0';
 }
 
 
-void readLiteral(const char* literal, std::istream& json)
+void readLiteral(const char* literal, BufferContext& json)
 {
-    char c;
+    const char* it = json.cursor();
+    const char* end = json.end();
+
     const char* l = literal;
-    while (json && *l && (c = json.get()) == *l) l++;
+    for (; *l && it < end && *it == *l; ++l, ++it);
 
-    if (*l) reflectError("expected literal <%s>", literal);
+    if (*l) return json.fail("expected literal <%s>", literal);
+    json.seek(it);
 }
 
-std::string readUnicode(std::istream& json)
+uint32_t readHex(BufferContext& json)
 {
-    char c;
-    uint32_t code = 0;
+    if (json.end() - json.cursor() < 4) {
+        json.fail("unexpected end of unicode code point");
+        return 0;
+    }
 
-    for (size_t i = 0; json && i < 4; ++i) {
+    uint32_t code = 0;
 
-        c = json.get();
-        code <<= 8;
+    for (size_t i = 0; i < 4; ++i) {
+        char c = json.pop();
+        code <<= 4;
 
              if (c >= '0' && c <= '9') code |= c - '0';
         else if (c >= 'a' && c <= 'f') code |= c - 'a' + 10;
         else if (c >= 'A' && c <= 'F') code |= c - 'A' + 10;
 
-        else reflectError("non-hex digit in unicode code point <%c>", c);
+        else {
+            json.fail("non-hex digit in unicode code point <%c>", c);
+            return 0;
+        }
+    }
+
+    return code;
+}
+
+void readUnicode(BufferContext& json, std::string& str)
+{
+    uint32_t code = readHex(json);
+    if (json.failed()) return;
+
+    // Code points outside of the BMP are escaped as a utf-16 surrogate pair.
+    if (code >= 0xD800 && code <= 0xDBFF) {
+        const char* it = json.cursor();
+        if (json.end() - it < 2 || it[0] != '\\' || it[1] != 'u')
+            return json.fail("unpaired utf-16 surrogate <%x>", code);
+
+        json.seek(it + 2);
+        uint32_t low = readHex(json);
+        if (json.failed()) return;
+
+        if (low < 0xDC00 || low > 0xDFFF)
+            return json.fail("invalid utf-16 low surrogate <%x>", low);
+
+        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
     }
 
     auto encode = [&] (unsigned pos, uint32_t mask, uint32_t head) -> char {
@@ -155,124 +223,148 @@ std::string readUnicode(std::istream& json)
     };
 
     if (code <= 0x7F) {
-        return {(char) code };
+        str += (char) code;
     }
 
-    if (code <= 0x7FF) {
-        code -= 0x80;
-        return {encode(1, 0x1F, 0xC0),
-                encode(0, 0x3F, 0x80)};
+    else if (code <= 0x7FF) {
+        str += encode(1, 0x1F, 0xC0);
+        str += encode(0, 0x3F, 0x80);
     }
 
-    if (code <= 0xFFFF) {
-        code -= 0x800;
-        return {encode(2, 0x0F, 0xE0),
-                encode(1, 0x3F, 0x80),
-                encode(0, 0x3F, 0x80)};
+    else if (code <= 0xFFFF) {
+        str += encode(2, 0x0F, 0xE0);
+        str += encode(1, 0x3F, 0x80);
+        str += encode(0, 0x3F, 0x80);
     }
 
-    if (code <= 0x1FFFFF) {
-        code -= 0x10000;
-        return {encode(3, 0x07, 0xF0),
-                encode(2, 0x3F, 0x80),
-                encode(1, 0x3F, 0x80),
-                encode(0, 0x3F, 0x80)};
+    else {
+        str += encode(3, 0x07, 0xF0);
+        str += encode(2, 0x3F, 0x80);
+        str += encode(1, 0x3F, 0x80);
+        str += encode(0, 0x3F, 0x80);
     }
-
-    if (code <= 0x3FFFFFFF) {
-        code -= 0x2000000;
-        return {encode(4, 0x03, 0xF8),
-                encode(3, 0x3F, 0x80),
-                encode(2, 0x3F, 0x80),
-                encode(1, 0x3F, 0x80),
-                encode(0, 0x3F, 0x80)};
-    }
-
-    code -= 0x400000000;
-    return {encode(5, 0x01, 0xFC),
-            encode(4, 0x3F, 0x80),
-            encode(3, 0x3F, 0x80),
-            encode(2, 0x3F, 0x80),
-            encode(1, 0x3F, 0x80),
-            encode(0, 0x3F, 0x80)};
 }
 
-std::string readString(std::istream& json)
+// Slow path for strings that contain escape sequences which can't be
+// referenced in place.
+std::string readEscapedString(const char* start, BufferContext& json)
 {
-    std::string str;
+    const Scanner& scan = scanner();
+    std::string str(start, json.cursor());
 
     while (json) {
-        char c = json.get();
+        const char* it = scan.findQuote(json.cursor(), json.end());
+        str.append(json.cursor(), it);
+        json.seek(it);
 
+        if (!json) break;
+
+        char c = json.pop();
         if (c == '"') return str;
-        if (c == '\\') {
-            switch(c = json.get()) {
-            case '"':
-            case '/':
-            case '\\': break;
-
-            case 'b': c = '\b'; break;
-            case 'f': c = '\f'; break;
-            case 'n': c = '\n'; break;
-            case 'r': c = '\r'; break;
-            case 't': c = '\t'; break;
-            case 'u': str += readUnicode(json); continue;
-            default: reflectError("unknown escaped character <%c>", c);
-            }
+
+        if (!json) break;
+
+        switch(c = json.pop()) {
+        case '"':
+        case '/':
+        case '\\': break;
+
+        case 'b': c = '\b'; break;
+        case 'f': c = '\f'; break;
+        case 'n': c = '\n'; break;
+        case 'r': c = '\r'; break;
+        case 't': c = '\t'; break;
+        case 'u': readUnicode(json, str); continue;
+        default:
+            json.fail("unknown escaped character <%c>", c);
+            return str;
         }
 
         str += c;
     };
 
-    reflectError("unexpected end of string");
+    json.fail("unexpected end of string");
+    return str;
+}
+
+Token readString(BufferContext& json)
+{
+    const char* start = json.cursor();
+    const char* end = json.end();
+
+    const char* it = scanner().findQuote(start, end);
+    if (it == end) {
+        json.fail("unexpected end of string");
+        return Token(Token::EOS);
+    }
+
+    if (*it == '\\') {
+        json.seek(it);
+        return Token(Token::String, readEscapedString(start, json));
+    }
+
+    json.seek(it + 1);
+    return Token(Token::String, start, it - start);
 }
 
-// \todo shouldn't allow leading 0s unless followed by a .
-// \todo enforce a number before a .
-std::string readNumber(char c, std::istream& json)
+// Validates the json number grammar but leading zeros are tolerated.
+Token readNumber(BufferContext& json)
 {
-    std::string str;
-    str += c;
+    // The first character was already consumed by nextToken.
+    const char* start = json.cursor() - 1;
+    const char* it = json.cursor();
+    const char* end = json.end();
 
     auto readDigits = [&] {
-        while (json && std::isdigit(c = json.peek())) str += json.get();
+        const char* first = it;
+        while (it < end && isDigit(*it)) ++it;
+        return it != first;
     };
 
     auto readChar = [&] (char c) {
-        if (!json || json.peek() != c) return false;
-
-        str += json.get();
+        if (it == end || *it != c) return false;
+        ++it;
         return true;
     };
 
     auto readChars = [&] (char a, char b) {
-        if (!json || (json.peek() != a && json.peek() != b))
-            return false;
-
-        str += json.get();
-        return true;
+        return readChar(a) || readChar(b);
     };
 
-    readChar('-');
-    readDigits();
+    bool valid = true;
 
-    if (readChar('.')) readDigits();
+    if (*start == '-') valid = readDigits();
+    else if (isDigit(*start)) readDigits();
+    else {
+        json.seek(start);
+        json.fail("unexpected character <%c>", *start);
+        return Token(Token::EOS);
+    }
+
+    if (valid && readChar('.')) valid = readDigits();
 
-    if (readChars('e', 'E')) {
+    if (valid && readChars('e', 'E')) {
         readChars('+', '-');
-        readDigits();
+        valid = readDigits();
     }
 
-    return str;
+    json.seek(it);
+
+    if (!valid) {
+        json.fail("invalid number <%s>", std::string(start, it - start));
+        return Token(Token::EOS);
+    }
+
+    return Token(Token::Number, start, it - start);
 }
 
 } // namespace anonymous
 
 
-Token nextToken(std::istream& json)
+Token nextToken(BufferContext& json)
 {
     char c = nextChar(json);
-    if (!json) return Token(Token::EOS);
+    if (!c) return Token(Token::EOS);
 
     switch(c)
     {
@@ -289,12 +381,12 @@ Token nextToken(std::istream& json)
     case 't': readLiteral("rue", json);  return Token(Token::Bool, true);
     case 'f': readLiteral("alse", json); return Token(Token::Bool, false);
 
-    case '"': return Token(Token::String, readString(json));
-    default:  return Token(Token::Number, readNumber(c, json));
+    case '"': return readString(json);
+    default:  return readNumber(json);
     }
 }
 
-void expectToken(Token token, Token::Type expected)
+void expectToken(const Token& token, Token::Type expected)
 {
     if (token.type() == expected) return;
 
@@ -302,36 +394,102 @@ void expectToken(Token token, Token::Type expected)
             print(token.type()), print(expected));
 }
 
+bool expectToken(const Token& token, Token::Type expected, BufferContext& json)
+{
+    if (token.type() == expected) return true;
+
+    json.fail("unexpected <%s> expecting <%s>",
+            print(token.type()), print(expected));
+    return false;
+}
+
 
 /******************************************************************************/
 /* PRINTERS                                                                   */
 /******************************************************************************/
 
-void printNull(std::ostream& json)
+void newline(Writer& json, int indent)
 {
-    json << "null";
+    if (indent < 0) return;
+    json.put('\n');
+    json.fill(' ', indent * 4);
+}
+
+void space(Writer& json, int indent)
+{
+    if (indent < 0) return;
+    json.put(' ');
+}
+
+void printNull(Writer& json)
+{
+    json.write("null", 4);
+}
+
+void printBool(bool value, Writer& json)
+{
+    if (value) json.write("true", 4);
+    else json.write("false", 5);
+}
+
+void printString(const char* value, size_t len, Writer& json)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    json.put('"');
+
+    // Characters that don't need escaping are written out in runs.
+    const char* start = value;
+    const char* end = value + len;
+
+    for (const char* it = start; it < end; ++it) {
+        unsigned char c = *it;
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        json.write(start, it - start);
+        start = it + 1;
+
+        switch (c)
+        {
+        case '"':  json.write("\\\"", 2); break;
+        case '\\': json.write("\\\\", 2); break;
+        case '\b': json.write("\\b", 2); break;
+        case '\f': json.write("\\f", 2); break;
+        case '\n': json.write("\\n", 2); break;
+        case '\r': json.write("\\r", 2); break;
+        case '\t': json.write("\\t", 2); break;
+        default:
+            json.write("\\u00", 4);
+            json.put(hex[c >> 4]);
+            json.put(hex[c & 0xF]);
+        }
+    }
+
+    json.write(start, end - start);
+    json.put('"');
 }
 
-void printBool(bool value, std::ostream& json)
+void printString(const std::string& value, Writer& json)
 {
-    json << (value ? "true" : "false");
+    printString(value.data(), value.size(), json);
 }
 
-void printString(const std::string& value, std::ostream& json)
+void printInteger(long value, Writer& json)
 {
-    json << '"' << value << '"';
+    char* buffer = json.reserve(NumberBufferSize);
+    json.advance(formatInt(value, buffer));
 }
 
-void printInteger(long value, std::ostream& json)
+void printInteger(unsigned long value, Writer& json)
 {
-    json << value;
+    char* buffer = json.reserve(NumberBufferSize);
+    json.advance(formatUInt(value, buffer));
 }
 
-void printFloat(double value, std::ostream& json)
+void printFloat(double value, Writer& json)
 {
-    std::array<char, 256> buffer;
-    (void) snprintf(buffer.data(), buffer.size(), "%e", value);
-    json << std::string(buffer.data());
+    char* buffer = json.reserve(NumberBufferSize);
+    json.advance(formatFloat(value, buffer));
 }
 
 } // namespace json
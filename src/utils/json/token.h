@@ -7,6 +7,9 @@
 
 #pragma once
 
+#include "context.h"
+#include "writer.h"
+
 #include <string>
 
 namespace reflect {
@@ -16,6 +19,11 @@ namespace json {
 /* TOKEN                                                                      */
 /******************************************************************************/
 
+/** Strings and numbers refer directly to the characters of the buffer they
+    were read from which means that a token is only valid for as long as its
+    buffer is. Strings that contain escape sequences are the only tokens that
+    need to own their value.
+ */
 struct Token
 {
     enum Type
@@ -29,21 +37,34 @@ struct Token
     };
 
     Token(Type type, bool value);
-    Token(Type type, std::string value = "");
+    Token(Type type, const char* ptr = nullptr, size_t len = 0);
+    Token(Type type, std::string value);
 
     Type type() const { return type_; }
 
-    std::string stringValue() const;
+    const char* data() const { return ptr_ ? ptr_ : value_.data(); }
+    size_t size() const { return ptr_ ? len_ : value_.size(); }
+
+    std::string stringValue() const { return std::string(data(), size()); }
 
     double floatValue() const;
     long intValue() const;
+    unsigned long uintValue() const;
+
+    // Returns false instead of raising an error if out of range.
+    bool intValue(long& value) const;
+    bool uintValue(unsigned long& value) const;
 
-    bool boolValue() const;
+    bool boolValue() const { return bool_; }
 
     std::string print() const;
 
 private:
     Type type_;
+    bool bool_;
+
+    const char* ptr_;
+    size_t len_;
     std::string value_;
 };
 
@@ -54,19 +75,29 @@ std::string print(Token::Type type);
 /* TOKENIZER                                                                  */
 /******************************************************************************/
 
-Token nextToken(std::istream& json);
-void expectToken(Token token, Token::Type expected);
+Token nextToken(BufferContext& json);
+void expectToken(const Token& token, Token::Type expected);
+
+// Fails the context instead of raising an error.
+bool expectToken(const Token& token, Token::Type expected, BufferContext& json);
 
 
 /******************************************************************************/
 /* PRINTERS                                                                   */
 /******************************************************************************/
 
-void printNull(std::ostream& json);
-void printBool(bool value, std::ostream& json);
-void printInteger(long value, std::ostream& json);
-void printFloat(double value, std::ostream& json);
-void printString(const std::string& value, std::ostream& json);
+void printNull(Writer& json);
+void printBool(bool value, Writer& json);
+void printInteger(long value, Writer& json);
+void printInteger(unsigned long value, Writer& json);
+void printFloat(double value, Writer& json);
+void printString(const std::string& value, Writer& json);
+void printString(const char* value, size_t len, Writer& json);
+
+// Pretty printing helpers; a negative indent disables pretty printing.
+void newline(Writer& json, int indent);
+void space(Writer& json, int indent);
+inline int inc(int indent) { return indent < 0 ? -1 : (indent + 1); }
 
 
 } // namespace json
@@ -0,0 +1,184 @@
+/* writer.cpp                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   json output sinks implementation.
+*/
+
+#include "writer.h"
+#include "reflect.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <unistd.h>
+
+namespace reflect {
+namespace json {
+
+/******************************************************************************/
+/* WRITER                                                                     */
+/******************************************************************************/
+
+void
+Writer::
+writeSlow(const char* data, size_t len)
+{
+    while (len) {
+        if (it_ == end_) overflow(len);
+
+        size_t n = std::min<size_t>(len, end_ - it_);
+        std::memcpy(it_, data, n);
+
+        it_ += n;
+        data += n;
+        len -= n;
+    }
+}
+
+void
+Writer::
+fill(char c, size_t n)
+{
+    while (n) {
+        if (it_ == end_) overflow(n);
+
+        size_t chunk = std::min<size_t>(n, end_ - it_);
+        std::memset(it_, c, chunk);
+
+        it_ += chunk;
+        n -= chunk;
+    }
+}
+
+
+/******************************************************************************/
+/* STRING WRITER                                                              */
+/******************************************************************************/
+
+StringWriter::
+StringWriter(size_t capacity)
+{
+    capacity = std::max<size_t>(capacity, MinCapacity);
+    buffer_.reset(new char[capacity]);
+    reset(buffer_.get(), buffer_.get(), buffer_.get() + capacity);
+}
+
+void
+StringWriter::
+overflow(size_t n)
+{
+    size_t size = it_ - start_;
+    size_t capacity = std::max<size_t>((end_ - start_) * 2, size + n);
+
+    std::unique_ptr<char[]> buffer(new char[capacity]);
+    std::memcpy(buffer.get(), start_, size);
+
+    buffer_ = std::move(buffer);
+    reset(buffer_.get(), buffer_.get() + size, buffer_.get() + capacity);
+}
+
+
+/******************************************************************************/
+/* BUFFERED WRITER                                                            */
+/******************************************************************************/
+
+BufferedWriter::
+BufferedWriter(size_t capacity)
+{
+    capacity = std::max<size_t>(capacity, MinCapacity);
+    buffer_.reset(new char[capacity]);
+    reset(buffer_.get(), buffer_.get(), buffer_.get() + capacity);
+}
+
+void
+BufferedWriter::
+flush()
+{
+    if (it_ == start_) return;
+
+    drain(start_, it_ - start_);
+    it_ = start_;
+}
+
+void
+BufferedWriter::
+overflow(size_t)
+{
+    flush();
+}
+
+
+/******************************************************************************/
+/* FD WRITER                                                                  */
+/******************************************************************************/
+
+namespace {
+
+// Leaves errno set on failure.
+bool writeFd(int fd, const char* data, size_t len)
+{
+    while (len) {
+        ssize_t written = ::write(fd, data, len);
+
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        data += written;
+        len -= written;
+    }
+
+    return true;
+}
+
+} // namespace anonymous
+
+FdWriter::
+FdWriter(int fd, size_t capacity) :
+    BufferedWriter(capacity), fd_(fd)
+{}
+
+FdWriter::
+~FdWriter()
+{
+    // Errors can't be reported from here; they're only raised by flush().
+    (void) writeFd(fd_, start_, it_ - start_);
+}
+
+void
+FdWriter::
+drain(const char* data, size_t len)
+{
+    if (!writeFd(fd_, data, len))
+        reflectError("unable to write json: %s", strerror(errno));
+}
+
+
+/******************************************************************************/
+/* STREAM WRITER                                                              */
+/******************************************************************************/
+
+StreamWriter::
+StreamWriter(std::ostream& stream, size_t capacity) :
+    BufferedWriter(capacity), stream_(stream)
+{}
+
+StreamWriter::
+~StreamWriter()
+{
+    // Streams only throw if asked to and errors can't be reported from here;
+    // they're left for flush() or the stream's state to report.
+    try { drain(start_, it_ - start_); }
+    catch (...) {}
+}
+
+void
+StreamWriter::
+drain(const char* data, size_t len)
+{
+    stream_.write(data, len);
+}
+
+} // namespace json
+} // namespace reflect
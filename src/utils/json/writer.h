@@ -0,0 +1,174 @@
+/* writer.h                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   json output sinks.
+*/
+
+#pragma once
+
+#include <string>
+#include <memory>
+#include <ostream>
+#include <cstring>
+
+namespace reflect {
+namespace json {
+
+/******************************************************************************/
+/* WRITER                                                                     */
+/******************************************************************************/
+
+/** Output sink for the json printers which writes into a contiguous buffer.
+    Writing only involves copying into the buffer until it fills up at which
+    point the implementation either grows it or drains it somewhere else.
+
+    Implementations of overflow must leave room for at least n bytes if n is
+    no larger than MinCapacity and at least one byte otherwise.
+ */
+struct Writer
+{
+    enum { MinCapacity = 64 };
+
+    Writer() : start_(nullptr), it_(nullptr), end_(nullptr) {}
+    virtual ~Writer() {}
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    void put(char c)
+    {
+        if (it_ == end_) overflow(1);
+        *it_++ = c;
+    }
+
+    void write(const char* data, size_t len)
+    {
+        if (size_t(end_ - it_) < len) writeSlow(data, len);
+        else {
+            std::memcpy(it_, data, len);
+            it_ += len;
+        }
+    }
+
+    void write(const std::string& str) { write(str.data(), str.size()); }
+
+    void fill(char c, size_t n);
+
+    /** Returns a pointer to at least n writable bytes where n must be no
+        larger than MinCapacity. The bytes are only written out once they're
+        committed via advance.
+     */
+    char* reserve(size_t n)
+    {
+        if (size_t(end_ - it_) < n) overflow(n);
+        return it_;
+    }
+
+    void advance(size_t n) { it_ += n; }
+
+    // Writes out any buffered bytes if the writer has somewhere to send them.
+    virtual void flush() {}
+
+protected:
+    virtual void overflow(size_t n) = 0;
+
+    void reset(char* start, char* it, char* end)
+    {
+        start_ = start;
+        it_ = it;
+        end_ = end;
+    }
+
+    char* start_;
+    char* it_;
+    char* end_;
+
+private:
+    void writeSlow(const char* data, size_t len);
+};
+
+
+/******************************************************************************/
+/* STRING WRITER                                                              */
+/******************************************************************************/
+
+/** Accumulates the output in a buffer that grows as needed. */
+struct StringWriter : public Writer
+{
+    explicit StringWriter(size_t capacity = 256);
+
+    const char* data() const { return start_; }
+    size_t size() const { return it_ - start_; }
+    std::string str() const { return std::string(data(), size()); }
+
+    void clear() { it_ = start_; }
+
+protected:
+    virtual void overflow(size_t n);
+
+private:
+    std::unique_ptr<char[]> buffer_;
+};
+
+
+/******************************************************************************/
+/* BUFFERED WRITER                                                            */
+/******************************************************************************/
+
+/** Fixed size buffer which is drained whenever it fills up or is flushed.
+    Destruction writes out whatever is left in the buffer but ignores any
+    errors so flush() must be called explicitly to have them reported.
+ */
+struct BufferedWriter : public Writer
+{
+    explicit BufferedWriter(size_t capacity);
+
+    virtual void flush();
+
+protected:
+    virtual void overflow(size_t n);
+    virtual void drain(const char* data, size_t len) = 0;
+
+private:
+    std::unique_ptr<char[]> buffer_;
+};
+
+
+/******************************************************************************/
+/* FD WRITER                                                                  */
+/******************************************************************************/
+
+/** Writes to a file descriptor which is not closed by the writer. */
+struct FdWriter : public BufferedWriter
+{
+    explicit FdWriter(int fd, size_t capacity = 1 << 16);
+    ~FdWriter();
+
+protected:
+    virtual void drain(const char* data, size_t len);
+
+private:
+    int fd_;
+};
+
+
+/******************************************************************************/
+/* STREAM WRITER                                                              */
+/******************************************************************************/
+
+/** Adapter for std::ostream. */
+struct StreamWriter : public BufferedWriter
+{
+    explicit StreamWriter(std::ostream& stream, size_t capacity = 1 << 12);
+    ~StreamWriter();
+
+protected:
+    virtual void drain(const char* data, size_t len);
+
+private:
+    std::ostream& stream_;
+};
+
+} // namespace json
+} // namespace reflect
@@ -7,6 +7,8 @@
 
 #include "reflect.h"
 
+#include <thread>
+
 namespace reflect {
 
 
@@ -15,13 +17,14 @@ namespace reflect {
 /******************************************************************************/
 
 Value::
-Value() : value_(nullptr) {}
+Value() : value_(nullptr), promoting_(false) {}
 
 Value::
 Value(const Value& other) :
     arg(other.arg),
-    value_(other.value_),
-    storage(other.storage)
+    value_(other.share()),
+    storage(other.storage),
+    promoting_(false)
 {}
 
 Value&
@@ -30,9 +33,12 @@ operator=(const Value& other)
 {
     if (this == &other) return *this;
 
+    void* ptr = other.share();
+
     arg = other.arg;
-    value_ = other.value_;
     storage = other.storage;
+    value_.store(ptr, std::memory_order_relaxed);
+    promoting_.store(false, std::memory_order_relaxed);
 
     return *this;
 }
@@ -40,9 +46,17 @@ operator=(const Value& other)
 Value::
 Value(Value&& other) :
     arg(std::move(other.arg)),
-    value_(std::move(other.value_)),
-    storage(std::move(other.storage))
-{}
+    value_(other.value()),
+    storage(std::move(other.storage)),
+    promoting_(false)
+{
+    if (other.isInline()) {
+        inline_ = other.inline_;
+        value_.store(&inline_, std::memory_order_relaxed);
+    }
+
+    other.reset();
+}
 
 Value&
 Value::
@@ -50,13 +64,53 @@ operator=(Value&& other)
 {
     if (this == &other) return *this;
 
+    void* ptr = other.value();
+
     arg = std::move(other.arg);
-    value_ = std::move(other.value_);
     storage = std::move(other.storage);
+    promoting_.store(false, std::memory_order_relaxed);
+
+    if (other.isInline()) {
+        inline_ = other.inline_;
+        ptr = &inline_;
+    }
+    value_.store(ptr, std::memory_order_relaxed);
 
+    other.reset();
     return *this;
 }
 
+void
+Value::
+reset()
+{
+    arg = Argument();
+    storage.reset();
+    value_.store(nullptr, std::memory_order_relaxed);
+    promoting_.store(false, std::memory_order_relaxed);
+}
+
+void*
+Value::
+share() const
+{
+    void* ptr = value();
+    if (ptr != &inline_) return ptr;
+
+    // Someone else beat us to it so wait for the block to be published.
+    if (promoting_.exchange(true, std::memory_order_acquire)) {
+        while ((ptr = value()) == &inline_) std::this_thread::yield();
+        return ptr;
+    }
+
+    // Inline values are always trivial so a raw copy of the buffer will do.
+    storage = std::make_shared<ValueInlineStorage>(inline_);
+    ptr = storage.get();
+    value_.store(ptr, std::memory_order_release);
+
+    return ptr;
+}
+
 const std::string&
 Value::
 typeId() const
@@ -64,6 +118,13 @@ typeId() const
     return type()->id();
 }
 
+bool
+Value::
+is(Trait trait) const
+{
+    return type()->is(trait);
+}
+
 bool
 Value::
 is(const std::string& trait) const
@@ -72,6 +133,29 @@ is(const std::string& trait) const
 }
 
 
+Value
+Value::
+field(const FieldDescriptor& field) const
+{
+    if (field.hasOffset()) {
+        // The field lives within our object so the result needs to keep our
+        // storage alive which is why inline values must first be shared.
+        void* ptr = static_cast<char*>(share()) + field.offset;
+
+        Value result;
+        result.arg = Argument(field.type, RefType::LValue, isConst());
+        result.value_.store(ptr, std::memory_order_relaxed);
+        if (storage) result.storage = std::shared_ptr<void>(storage, ptr);
+        return result;
+    }
+
+    if (!field.getter)
+        reflectError("<%s> has no getter for field <%s>", typeId(), field.name);
+
+    return field.getter->invoke<Value>(*this);
+}
+
+
 Value
 Value::
 copy() const
@@ -107,15 +191,18 @@ bool
 Value::
 operator!() const
 {
-    if (type()->hasFunction("operator!"))
-        return call<bool>("operator!");
+    static const Symbol fn("operator!");
+
+    if (type()->hasFunction(fn))
+        return call<bool>(fn);
     return !((bool) *this);
 }
 
 Value::
 operator bool() const
 {
-    return call<bool>("operator bool()");
+    static const Symbol fn("operator bool()");
+    return call<bool>(fn);
 }
 
 
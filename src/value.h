@@ -11,6 +11,7 @@
 namespace reflect {
 
 struct Type;
+struct FieldDescriptor;
 
 /******************************************************************************/
 /* CLEAN REF                                                                  */
@@ -44,31 +45,43 @@ struct CleanValue
 #define reflectValueOpUnary(op)                 \
     Value op() const                            \
     {                                           \
-        return call<Value>(#op);                \
+        static const Symbol fn(#op);            \
+        return call<Value>(fn);                 \
     }
 
 #define reflectValueOpBinary(op)                                \
     template<typename Arg>                                      \
     Value op(Arg&& arg) const                                   \
     {                                                           \
-        return call<Value>(#op, std::forward<Arg>(arg));        \
+        static const Symbol fn(#op);                            \
+        return call<Value>(fn, std::forward<Arg>(arg));         \
     }
 
 #define reflectValueOpBool(op)                          \
     template<typename Arg>                              \
     bool op(Arg&& arg) const                            \
     {                                                   \
-        return call<bool>(#op, std::forward<Arg>(arg)); \
+        static const Symbol fn(#op);                    \
+        return call<bool>(fn, std::forward<Arg>(arg));  \
     }
 
 #define reflectValueOpNary(op)                                  \
     template<typename... Args>                                  \
     Value op(Args&&... args) const                              \
     {                                                           \
-        return call<Value>(#op, std::forward<Args>(args)...);   \
+        static const Symbol fn(#op);                            \
+        return call<Value>(fn, std::forward<Args>(args)...);    \
     }
 
 
+/******************************************************************************/
+/* VALUE INLINE STORAGE                                                       */
+/******************************************************************************/
+
+enum { ValueInlineSize = 16 };
+typedef std::aligned_storage<ValueInlineSize>::type ValueInlineStorage;
+
+
 /******************************************************************************/
 /* VALUE                                                                      */
 /******************************************************************************/
@@ -86,16 +99,17 @@ struct Value
     Value(Value&& other);
     Value& operator=(Value&& other);
 
-    void* value() const { return value_; }
+    void* value() const { return value_.load(std::memory_order_acquire); }
     const Type* type() const { return arg.type(); }
     const std::string& typeId() const;
     RefType refType() const { return arg.refType(); }
     bool isConst() const { return arg.isConst(); }
     bool isVoid() const { return arg.isVoid(); }
-    bool isStored() const { return !!storage; }
+    bool isStored() const { return isInline() || storage; }
 
     const Argument& argument() const { return arg; }
 
+    bool is(Trait trait) const;
     bool is(const std::string& trait) const;
 
     // Get a reference to the value without any type checks.
@@ -114,15 +128,26 @@ struct Value
     Value copy() const;
     Value move();
 
+    // The string overloads never intern the name. See Type::function().
+    template<typename Ret, typename... Args>
+    Ret call(Symbol fn, Args&&... args) const;
     template<typename Ret, typename... Args>
     Ret call(const std::string& fn, Args&&... args) const;
 
+    template<typename Ret>
+    Ret get(Symbol field) const;
     template<typename Ret>
     Ret get(const std::string& field) const;
 
+    template<typename Arg>
+    void set(Symbol field, Arg&& arg) const;
     template<typename Arg>
     void set(const std::string& field, Arg&& arg) const;
 
+    // Reads the field in place if its offset is known and falls back on the
+    // getter otherwise. A field read in place keeps this object alive.
+    Value field(const FieldDescriptor& field) const;
+
     // operator= for the contained value.
     template<typename Arg>
     void assign(Arg&& arg) const;
@@ -177,9 +202,32 @@ private:
     template<typename T>
     T convert() const;
 
+    /** Small trivial values (primitives, pointers, etc.) are stored inline
+        which avoids any heap allocation for the temporaries returned by
+        reflected functions. Everything else lives in a single shared heap
+        block.
+
+        Copies of a Value must refer to the same object so copying an inline
+        value first promotes it to the heap where it can then be shared by both
+        Value objects. Temporaries are usually moved around instead of copied
+        so this rarely happens in practice. Note that moving an inline Value
+        relocates the object it contains.
+
+        Since copying is a const operation, a promotion can race with other
+        copies or reads of the same Value. The first thread to raise
+        promoting_ builds the heap block and publishes it through value_
+        while the others wait for it. storage is only ever read after value_
+        was seen to point outside of the inline buffer.
+     */
+    bool isInline() const { return value() == &inline_; }
+    void* share() const;
+    void reset();
+
     Argument arg;
-    void* value_;
-    std::shared_ptr<void> storage;
+    mutable std::atomic<void*> value_;
+    mutable std::shared_ptr<void> storage;
+    ValueInlineStorage inline_;
+    mutable std::atomic<bool> promoting_;
 };
 
 
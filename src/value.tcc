@@ -25,12 +25,17 @@ struct IsMovable
 };
 
 template<typename T>
-struct ValueDestructor
+struct IsInlineStorable
 {
-    void operator() (void* ptr) const
-    {
-        static_cast<T*>(ptr)->~T();
-    }
+    typedef typename std::decay<T>::type CleanT;
+
+    static constexpr bool value =
+        std::is_trivial<CleanT>::value &&
+        std::is_copy_constructible<CleanT>::value &&
+        sizeof(CleanT) <= ValueInlineSize &&
+        alignof(CleanT) <= alignof(ValueInlineStorage);
+
+    typedef std::integral_constant<bool, value> type;
 };
 
 
@@ -39,42 +44,63 @@ struct ValueDestructor
 /******************************************************************************/
 
 template<typename T, typename Meh>
-void* store(T&& value, std::true_type, Meh)
+std::shared_ptr<void> store(T&& value, std::true_type, Meh)
 {
     typedef typename std::decay<T>::type CleanT;
-    return new CleanT(std::move(value));
+    return std::make_shared<CleanT>(std::move(value));
 }
 
 template<typename T>
-void* store(T&& value, std::false_type, std::true_type)
+std::shared_ptr<void> store(T&& value, std::false_type, std::true_type)
 {
     typedef typename std::decay<T>::type CleanT;
-    return new CleanT(value);
+    return std::make_shared<CleanT>(value);
 }
 
 template<typename T, typename... Rest>
-void* store(Rest&&...)
+std::shared_ptr<void> store(Rest&&...)
 {
     reflectError(
             "<%s> cannot be stored (no move/copy constructor)",
             printArgument<T>());
 }
 
+template<typename T>
+void* storeInline(void* buffer, T&& value, std::true_type)
+{
+    typedef typename std::decay<T>::type CleanT;
+    return new (buffer) CleanT(value);
+}
+
+template<typename T>
+void* storeInline(void*, T&&, std::false_type)
+{
+    return nullptr;
+}
+
 template<typename T>
 Value::
 Value(T&& value) :
     arg(Argument::make(std::forward<T>(value))),
-    value_((void*)&value) // cast-away any const
+    value_((void*)&value), // cast-away any const
+    promoting_(false)
 {
     if (refType() != RefType::RValue) return;
 
     typedef typename std::decay<T>::type CleanT;
 
-    value_ = store<T>(std::forward<T>(value),
-            typename IsMovable<T>::type(),
-            typename std::is_copy_constructible<CleanT>::type());
+    void* ptr = storeInline(&inline_, std::forward<T>(value),
+            typename IsInlineStorable<T>::type());
 
-    storage.reset(value_, ValueDestructor<CleanT>());
+    if (!ptr) {
+        storage = store<T>(std::forward<T>(value),
+                typename IsMovable<T>::type(),
+                typename std::is_copy_constructible<CleanT>::type());
+        ptr = storage.get();
+    }
+
+    // Not yet visible to anyone else so no ordering is required.
+    value_.store(ptr, std::memory_order_relaxed);
 
     // We now own the value so we're now l-ref-ing our internal storage.
     arg = Argument(arg.type(), RefType::LValue, false);
@@ -91,7 +117,7 @@ get() const
                 type()->id(), reflect::type<T>()->id());
     }
 
-    return *static_cast<T*>(value_);
+    return *static_cast<T*>(value());
 }
 
 
@@ -117,7 +143,7 @@ cast() const -> typename CleanRef<T>::type
     // no conversion can take place if we're returning a ref.
 
     typedef typename std::decay<T>::type CleanT;
-    return *static_cast<CleanT*>(value_);
+    return *static_cast<CleanT*>(value());
 }
 
 
@@ -129,7 +155,7 @@ convert() const
     reflectStaticAssert((std::is_same< T, typename std::decay<T>::type>::value));
 
     auto& converter = type()->converter<T>();
-    return converter.call<T>(*this);
+    return converter.template call<T>(*this);
 }
 
 
@@ -156,7 +182,7 @@ copy() const -> typename CleanValue<T>::type
     typedef typename std::decay<T>::type CleanT;
 
     if (type()->isChildOf<T>())
-        return *static_cast<const T*>(value_);
+        return *static_cast<const T*>(value());
 
     return convert<CleanT>();
 }
@@ -189,7 +215,7 @@ move() -> typename CleanValue<T>::type
     typedef typename std::decay<T>::type CleanT;
 
     CleanT value = type()->isChildOf<T>() ?
-        std::move(*static_cast<CleanT*>(value_)) :
+        std::move(*static_cast<CleanT*>(this->value())) :
         convert<CleanT>();
 
     *this = Value();
@@ -197,6 +223,15 @@ move() -> typename CleanValue<T>::type
 }
 
 
+template<typename Ret, typename... Args>
+Ret
+Value::
+call(Symbol fn, Args&&... args) const
+{
+    const auto& f = type()->function(fn);
+    return f.call<Ret>(*this, std::forward<Args>(args)...);
+}
+
 template<typename Ret, typename... Args>
 Ret
 Value::
@@ -206,6 +241,14 @@ call(const std::string& fn, Args&&... args) const
     return f.call<Ret>(*this, std::forward<Args>(args)...);
 }
 
+template<typename Ret>
+Ret
+Value::
+get(Symbol field) const
+{
+    return call<Ret>(field);
+}
+
 template<typename Ret>
 Ret
 Value::
@@ -214,6 +257,14 @@ get(const std::string& field) const
     return call<Ret>(field);
 }
 
+template<typename Arg>
+void
+Value::
+set(Symbol field, Arg&& arg) const
+{
+    call<void>(field, std::forward<Arg>(arg));
+}
+
 template<typename Arg>
 void
 Value::
@@ -227,7 +278,8 @@ void
 Value::
 assign(Arg&& arg) const
 {
-    call<void>("operator=", std::forward<Arg>(arg));
+    static const Symbol fn("operator=");
+    call<void>(fn, std::forward<Arg>(arg));
 }
 
 
@@ -19,6 +19,11 @@
    Value object before being returned which means that any temporaries will be
    stored in Value and is therefor safe to use by the caller.
 
+   When the caller already knows that its arguments are an exact match for the
+   function's parameters, the boxing can be skipped altogether by going through
+   invoke() which takes raw pointers to the arguments along with a slot for the
+   return value.
+
 */
 
 #include "reflect.h"
@@ -47,6 +52,18 @@ struct ValueFunctionBase< TypeVector<Values...> >
         job for the compiler...
      */
     virtual void free() = 0;
+
+    /** Calls the function without boxing anything. Each entry of args must
+        point to an object of the exact parameter type and will be moved from
+        if the parameter is taken by value or by r-value reference.
+
+        If ret is null then the return value is discarded. Otherwise, a
+        returned reference is written to ret as a pointer to the referee and a
+        returned value is constructed in place within ret which must be
+        properly sized and aligned. Destroying that object is then up to the
+        caller.
+     */
+    virtual void invoke(void* ret, void** args) = 0;
 };
 
 
@@ -56,6 +73,36 @@ struct ValueFunction :
 {};
 
 
+/******************************************************************************/
+/* DIRECT CAST                                                                */
+/******************************************************************************/
+
+namespace details {
+
+template<typename T>
+T&& directCast(void* arg)
+{
+    typedef typename std::remove_reference<T>::type CleanT;
+    return static_cast<T&&>(*static_cast<CleanT*>(arg));
+}
+
+template<typename T>
+void directReturn(void* ret, T&& value, std::true_type)
+{
+    const void* ptr = &value;
+    *static_cast<void**>(ret) = const_cast<void*>(ptr);
+}
+
+template<typename T>
+void directReturn(void* ret, T&& value, std::false_type)
+{
+    typedef typename std::decay<T>::type CleanT;
+    new (ret) CleanT(std::move(value));
+}
+
+} // namespace details
+
+
 /******************************************************************************/
 /* VALUE FUNCTION IMPL                                                        */
 /******************************************************************************/
@@ -81,6 +128,13 @@ struct ValueFunctionImpl< Fn, TypeVector<Values...> > :
         return call(IsVoidRet(), values...);
     }
 
+    virtual void invoke(void* ret, void** args)
+    {
+        typedef typename std::is_same<Ret, void>::type IsVoidRet;
+
+        invoke(IsVoidRet(), ret, args);
+    }
+
 
 private:
 
@@ -130,6 +184,58 @@ private:
         return fn(cast<Args>(values)...);
     }
 
+
+    typedef typename MakeIndexes<sizeof...(Values)>::type Indexes;
+
+    void invoke(std::true_type, void*, void** args)
+    {
+        typedef typename FnType::type type;
+        typedef typename FnType::Arguments Args;
+
+        invoke(type(), Args(), Indexes(), args);
+    }
+
+    void invoke(std::false_type, void* ret, void** args)
+    {
+        typedef typename FnType::type type;
+        typedef typename FnType::Arguments Args;
+        typedef typename std::is_reference<Ret>::type IsRefRet;
+
+        if (!ret) {
+            invoke(type(), Args(), Indexes(), args);
+            return;
+        }
+
+        details::directReturn(
+                ret, invoke(type(), Args(), Indexes(), args), IsRefRet());
+    }
+
+
+    template<typename... Args, size_t... I>
+    Ret invoke(
+            GlobalFunction, TypeVector<Args...>,
+            reflect::Indexes<I...>, void** args)
+    {
+        return (*fn)(details::directCast<Args>(args[I])...);
+    }
+
+    template<typename Obj, typename... Args, size_t I, size_t... Rest>
+    Ret invoke(
+            MemberFunction, TypeVector<Obj, Args...>,
+            reflect::Indexes<I, Rest...>, void** args)
+    {
+        return (details::directCast<Obj>(args[I]).*fn)(
+                details::directCast<Args>(args[Rest])...);
+    }
+
+    template<typename... Args, size_t... I>
+    Ret invoke(
+            FunctorFunction, TypeVector<Args...>,
+            reflect::Indexes<I...>, void** args)
+    {
+        return fn(details::directCast<Args>(args[I])...);
+    }
+
     Fn fn;
 };
 
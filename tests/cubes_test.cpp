@@ -16,7 +16,6 @@
 #include "utils/config/includes.h"
 
 #include <boost/test/unit_test.hpp>
-#include <fstream>
 
 using namespace reflect;
 
@@ -169,10 +168,82 @@ reflectType(RunCube)
 
 BOOST_AUTO_TEST_CASE(CubesAndTubes)
 {
-    std::ifstream ifs("tests/data/cubes.json");
-
     config::Config cubes;
-    config::loadJson(cubes, ifs);
+    config::loadJsonFile(cubes, "tests/data/cubes.json");
 
     (*cubes["runner"]).call<void>("run");
 }
+
+BOOST_AUTO_TEST_CASE(SaveAndReload)
+{
+    config::Config cubes;
+    config::loadJsonFile(cubes, "tests/data/cubes.json");
+
+    std::string json = config::saveJson(cubes, "");
+
+    config::Config copy;
+    config::loadJson(copy, json);
+    BOOST_CHECK_EQUAL(config::saveJson(copy, ""), json);
+
+    BOOST_CHECK_NE(json.find("\"value\": \"Hello \""), std::string::npos);
+    (*copy["runner"]).call<void>("run");
+
+    // Only the fields with the trait are written.
+    BOOST_CHECK_EQUAL(config::saveJson(copy).find("Hello "), std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(LinkOrder)
+{
+    config::Config cfg;
+    config::loadJson(cfg,
+            "{ \"#a\": \"b\", \"#b\": \"c.0\", \"c\": [ \"x\" ] }");
+    BOOST_CHECK_EQUAL(cfg["a"].get<std::string>(), "x");
+    BOOST_CHECK_EQUAL(cfg["b"].get<std::string>(), "x");
+
+    // Pointers are shared so cubes can refer to each other.
+    config::Config loop;
+    config::loadJson(loop,
+            "{ \"a!RunCube\": { \"#cubes\": [ \"b\" ] },"
+            "  \"b!RunCube\": { \"#cubes\": [ \"a\" ] } }");
+    BOOST_CHECK_EQUAL(loop.linkTargets().size(), 2u);
+    BOOST_CHECK(loop.count("a.cubes.0"));
+    BOOST_CHECK(loop.count("b.cubes.0"));
+}
+
+BOOST_AUTO_TEST_CASE(LinkCycles)
+{
+    // Equivalent to loading { "#a": "b", "#b": "a" }.
+    config::Config cycle;
+    cycle.set("c", Value(std::string("x")));
+
+    config::Config::Links links = {
+        { config::Path("c"), config::Path("b") },
+        { config::Path("a"), config::Path("b") },
+        { config::Path("b"), config::Path("a") },
+    };
+    BOOST_CHECK_THROW(cycle.link(links), ReflectError);
+    BOOST_CHECK(cycle.linkTargets().empty());
+    BOOST_CHECK(!cycle.count("a"));
+    BOOST_CHECK(!cycle.count("b"));
+    BOOST_CHECK_EQUAL(cycle["c"].get<std::string>(), "x");
+
+    // Equivalent to loading { "#a": "a.x" }.
+    config::Config self;
+    links = { { config::Path("a"), config::Path("a.x") } };
+    BOOST_CHECK_THROW(self.link(links), ReflectError);
+    BOOST_CHECK(self.linkTargets().empty());
+    BOOST_CHECK(!self.count("a"));
+}
+
+BOOST_AUTO_TEST_CASE(ParallelLoad)
+{
+    config::Config cubes;
+    config::loadJsonFile(cubes, "tests/data/cubes.json");
+
+    config::Config parallel;
+    config::loadJsonFile(parallel, "tests/data/cubes.json", 4);
+    BOOST_CHECK_EQUAL(
+            config::saveJson(parallel, ""), config::saveJson(cubes, ""));
+
+    (*parallel["runner"]).call<void>("run");
+}
@@ -650,3 +650,99 @@ BOOST_AUTO_TEST_CASE(converters_call)
     BOOST_CHECK_EQUAL(rrefFn.call<int>(convConstLRef), doRRef(convConstLRef));
     BOOST_CHECK_EQUAL(rrefFn.call<int>(Conv(10)), doRRef(Conv(10)));
 }
+
+
+/******************************************************************************/
+/* DIRECT                                                                     */
+/******************************************************************************/
+
+template<typename Fn>
+bool isDirect(const Function& fn)
+{
+    return fn.isDirect(reflectReturn<Fn>(), reflectArguments<Fn>());
+}
+
+BOOST_AUTO_TEST_CASE(direct_test)
+{
+    typedef test::Object Object;
+
+    Function copy("copy", [] (Object obj) { return obj + 1; });
+    Function ref("ref", [] (Object& obj) -> Object& { return obj += 1; });
+
+    BOOST_CHECK( isDirect<Object(Object&&)>(copy));
+    BOOST_CHECK( isDirect<void(Object&&)>(copy));
+    BOOST_CHECK(!isDirect<Object(Object&)>(copy));
+    BOOST_CHECK(!isDirect<Object(const Object&&)>(copy));
+    BOOST_CHECK(!isDirect<Value(Object&&)>(copy));
+    BOOST_CHECK(!isDirect<Object(Value&&)>(copy));
+    BOOST_CHECK(!isDirect<int(Object&&)>(copy));
+
+    BOOST_CHECK( isDirect<Object&(Object&)>(ref));
+    BOOST_CHECK( isDirect<Object(Object&)>(ref));
+    BOOST_CHECK(!isDirect<Object&&(Object&)>(ref));
+}
+
+BOOST_AUTO_TEST_CASE(direct_call)
+{
+    typedef test::Object Object;
+
+    Function copy("copy", [] (Object obj) { return obj + 1; });
+    Function ref("ref", [] (Object& obj) -> Object& { return obj += 1; });
+    typedef int (Object::*Getter)() const;
+    Function member("value", static_cast<Getter>(&Object::value));
+
+    Object obj(10);
+    Object result = copy.invokeDirect<Object>(std::move(obj));
+    BOOST_CHECK_EQUAL(result.value(), 11);
+    BOOST_CHECK_EQUAL(obj.value(), 0);
+
+    Object& r = ref.invokeDirect<Object&>(result);
+    BOOST_CHECK_EQUAL(&r, &result);
+    BOOST_CHECK_EQUAL(result.value(), 12);
+
+    Object c = ref.invokeDirect<Object>(result);
+    BOOST_CHECK_EQUAL(c.value(), 13);
+    BOOST_CHECK_EQUAL(result.value(), 13);
+
+    ref.invokeDirect<void>(result);
+    BOOST_CHECK_EQUAL(result.value(), 14);
+
+    BOOST_CHECK_EQUAL(member.invokeDirect<int>(result), 14);
+
+    Value value(result);
+    BOOST_CHECK_EQUAL(member.invokeDirect<int>(value), 14);
+}
+
+
+/******************************************************************************/
+/* OVERLOADS                                                                  */
+/******************************************************************************/
+
+BOOST_AUTO_TEST_CASE(overloads_cache)
+{
+    Overloads fns;
+    fns.add(Function("foo", [] (int i) { return i + 1; }));
+
+    const Argument ret = Argument::make<int>();
+    const Argument intArg = Argument::make<int>();
+
+    auto first = fns.resolve(ret, &intArg, 1);
+    BOOST_CHECK_EQUAL(first.status, Overloads::Found);
+    BOOST_CHECK_EQUAL(first.fn, &fns[0]);
+    BOOST_CHECK_EQUAL(fns.call<int>(1), 2);
+
+    // Adding overloads must not move the ones that were handed out.
+    fns.add(Function("foo", [] (int i, int j) { return i + j; }));
+    fns.add(Function("foo", [] (int i, int j, int k) { return i + j + k; }));
+    BOOST_CHECK_EQUAL(fns.resolve(ret, &intArg, 1).fn, first.fn);
+    BOOST_CHECK_EQUAL(&fns[0], first.fn);
+    BOOST_CHECK_EQUAL(fns.call<int>(1, 2), 3);
+
+    // Cached resolutions are dropped when an overload is added.
+    const Argument objArg = Argument::make<test::Object>();
+    BOOST_CHECK_EQUAL(fns.resolve(ret, &objArg, 1).status, Overloads::NoMatch);
+
+    fns.add(Function("foo", [] (test::Object obj) { return obj.value(); }));
+    BOOST_CHECK_EQUAL(fns.resolve(ret, &objArg, 1).fn, &fns[3]);
+    BOOST_CHECK_EQUAL(fns.call<int>(test::Object(3)), 3);
+}
@@ -19,9 +19,18 @@
 #include "dsl/field.h"
 #include "utils/json/parser.h"
 #include "utils/json/printer.h"
+#include "utils/json/scan.h"
+#include "utils/json/sax.h"
+#include "utils/json/decoder.h"
+#include "utils/json/encoder.h"
+#include "utils/json/number.h"
+#include "utils/json/writer.h"
+#include "utils/json/lines.h"
 
 #include <boost/test/unit_test.hpp>
 #include <fstream>
+#include <sstream>
+#include <cstdio>
 
 using namespace std;
 using namespace reflect;
@@ -67,6 +76,32 @@ reflectType(Blah)
 }
 
 
+/******************************************************************************/
+/* GUARDED                                                                    */
+/******************************************************************************/
+
+struct Guarded
+{
+    Guarded() : value_(0) {}
+
+    long value() const { return value_; }
+    void value(long value)
+    {
+        if (value < 0) reflectError("negative value <%ld>", value);
+        value_ = value;
+    }
+
+private:
+    long value_;
+};
+
+reflectType(Guarded)
+{
+    reflectPlumbing();
+    reflectField(value);
+}
+
+
 /******************************************************************************/
 /* PARSING                                                                    */
 /******************************************************************************/
@@ -94,5 +129,388 @@ BOOST_AUTO_TEST_CASE(parsing)
     checkBleh(blah.map["foo"], 20, true);
     checkBleh(blah.map["bar"], 0, true);
 
+    auto mapped = json::parseFile<Blah>("tests/data/basics.json");
+    BOOST_CHECK_EQUAL(json::print(mapped), json::print(blah));
+
     json::print(blah, std::cerr, true);
 }
+
+
+/******************************************************************************/
+/* BUFFER                                                                     */
+/******************************************************************************/
+
+BOOST_AUTO_TEST_CASE(buffer)
+{
+    std::string json =
+        "{ \"str\": \"a\\\"b\\u00e9\\ud83d\\ude00\", "
+        "\"vec\": [ { \"i\": -12, \"b\": true } ] }xxx";
+
+    // The trailing garbage is excluded to make sure that the tokenizer doesn't
+    // rely on the buffer being null terminated.
+    auto blah = json::parse<Blah>(json.data(), json.size() - 3);
+
+    BOOST_CHECK_EQUAL(blah.str, "a\"b\xc3\xa9\xf0\x9f\x98\x80");
+
+    BOOST_CHECK_EQUAL(blah.vec.size(), 1u);
+    BOOST_CHECK_EQUAL(blah.vec[0].i, -12);
+    BOOST_CHECK_EQUAL(blah.vec[0].b, true);
+}
+
+
+/******************************************************************************/
+/* SCAN                                                                       */
+/******************************************************************************/
+
+BOOST_AUTO_TEST_CASE(scan)
+{
+    const json::Scanner* scanners[] = {
+        json::scalarScanner(), json::sse2Scanner(), json::avx2Scanner() };
+
+    std::cerr << "scanner: " << json::scanner().name << std::endl;
+
+    // Place the target at every position around the vector widths to exercise
+    // both the vectorized loops and their scalar tails.
+    for (size_t len = 0; len < 80; ++len) {
+        for (size_t pos = 0; pos <= len; ++pos) {
+            std::string spaces(len, ' ');
+            for (size_t i = 0; i < len; ++i) spaces[i] = " \n\t\r"[i % 4];
+            if (pos < len) spaces[pos] = 'x';
+
+            std::string chars(len, 'a');
+            if (pos < len) chars[pos] = pos % 2 ? '"' : '\\';
+
+            for (const json::Scanner* scanner : scanners) {
+                if (!scanner) continue;
+
+                const char* start = spaces.data();
+                const char* end = start + len;
+                BOOST_CHECK_EQUAL(scanner->skipSpace(start, end) - start, pos);
+
+                start = chars.data();
+                end = start + len;
+                BOOST_CHECK_EQUAL(scanner->findQuote(start, end) - start, pos);
+            }
+        }
+    }
+}
+
+
+/******************************************************************************/
+/* SAX                                                                        */
+/******************************************************************************/
+
+struct EventPrinter : public json::Handler
+{
+    std::stringstream ss;
+
+    void onObjectStart() { ss << "{ "; }
+    void onKey(const json::Token& key) { ss << key.stringValue() << ": "; }
+    void onObjectEnd() { ss << "} "; }
+
+    void onArrayStart() { ss << "[ "; }
+    void onArrayEnd() { ss << "] "; }
+
+    void onNull() { ss << "null "; }
+    void onBool(bool value) { ss << (value ? "true " : "false "); }
+    void onNumber(const json::Token& num) { ss << num.intValue() << " "; }
+    void onString(const json::Token& str)
+    {
+        ss << "'" << str.stringValue() << "' ";
+    }
+};
+
+BOOST_AUTO_TEST_CASE(sax)
+{
+    EventPrinter printer;
+    json::read(
+            "{ \"a\": [1, true, null], \"b\": { \"c\": \"d\" }, \"e\": [] }",
+            printer);
+
+    BOOST_CHECK_EQUAL(printer.ss.str(),
+            "{ a: [ 1 true null ] b: { c: 'd' } e: [ ] } ");
+}
+
+BOOST_AUTO_TEST_CASE(sax_stream)
+{
+    // Large enough to span several chunks with tokens split across them.
+    std::string doc = "[";
+    for (size_t i = 0; i < 20000; ++i) {
+        if (i) doc += ", ";
+        doc += "{ \"key" + std::to_string(i) + "\": [" + std::to_string(i)
+            + ", \"" + std::string(i % 13, 'x') + "\", true, null] }";
+    }
+    doc += "]";
+
+    EventPrinter expected;
+    json::read(doc, expected);
+
+    std::stringstream stream(doc);
+    EventPrinter printer;
+    json::read(stream, printer);
+
+    BOOST_CHECK(printer.ss.str() == expected.ss.str());
+
+    // Nesting is handled without recursion.
+    std::string deep = std::string(100000, '[') + std::string(100000, ']');
+    std::stringstream deepStream(deep);
+    json::Handler handler;
+    json::read(deepStream, handler);
+}
+
+
+/******************************************************************************/
+/* DECODER                                                                    */
+/******************************************************************************/
+
+BOOST_AUTO_TEST_CASE(decoder)
+{
+    typedef std::vector<Bleh> BlehVec;
+    typedef std::map<std::string, Bleh> BlehMap;
+
+    auto kind = [] (const Type* type) { return json::decoder(type).kind(); };
+
+    BOOST_CHECK_EQUAL(kind(type<Blah>()), json::Decoder::Object);
+    BOOST_CHECK_EQUAL(kind(type<Bleh>()), json::Decoder::Object);
+    BOOST_CHECK_EQUAL(kind(type<long>()), json::Decoder::Int);
+    BOOST_CHECK_EQUAL(kind(type<bool>()), json::Decoder::Bool);
+    BOOST_CHECK_EQUAL(kind(type<BlehVec>()), json::Decoder::List);
+    BOOST_CHECK_EQUAL(kind(type<BlehMap>()), json::Decoder::Generic);
+
+    // Compiled once and then served from the published snapshot.
+    const auto* compiled = &json::decoder(type<Blah>());
+    BOOST_CHECK_EQUAL(compiled, &json::decoder(type<Blah>()));
+
+    Blah blah;
+    blah.str = "before";
+    blah.vec.emplace_back(1, true);
+
+    // Fields that are not scalars are replaced instead of merged into.
+    json::parseInto(blah, "{ \"vec\": [ { \"i\": 2 }, { \"b\": true } ] }");
+
+    BOOST_CHECK_EQUAL(blah.str, "before");
+    BOOST_CHECK_EQUAL(blah.vec.size(), 2u);
+    BOOST_CHECK_EQUAL(blah.vec[0].i, 2);
+    BOOST_CHECK_EQUAL(blah.vec[0].b, false);
+    BOOST_CHECK_EQUAL(blah.vec[1].i, 0);
+    BOOST_CHECK_EQUAL(blah.vec[1].b, true);
+}
+
+
+/******************************************************************************/
+/* ENCODER                                                                    */
+/******************************************************************************/
+
+BOOST_AUTO_TEST_CASE(encoder)
+{
+    typedef std::vector<Bleh> BlehVec;
+    auto kind = [] (const Type* type) { return json::encoder(type).kind(); };
+
+    BOOST_CHECK_EQUAL(kind(type<Blah>()), json::Encoder::Object);
+    BOOST_CHECK_EQUAL(kind(type<BlehVec>()), json::Encoder::List);
+    BOOST_CHECK_EQUAL(kind(type<long>()), json::Encoder::Int);
+
+    const auto* compiled = &json::encoder(type<Blah>());
+    BOOST_CHECK_EQUAL(compiled, &json::encoder(type<Blah>()));
+
+    Blah blah;
+    blah.str = "a\"b\\c\n";
+    blah.vec.emplace_back(1, true);
+    blah.vec.emplace_back(-2, false);
+    blah.map["x"] = Bleh(3, true);
+
+    std::string json = json::print(blah);
+    BOOST_CHECK_EQUAL(json,
+            "{\"map\":{\"x\":{\"b\":true,\"i\":3}},"
+            "\"str\":\"a\\\"b\\\\c\\n\","
+            "\"vec\":[{\"b\":true,\"i\":1},{\"b\":false,\"i\":-2}]}");
+
+    auto copy = json::parse<Blah>(json);
+    BOOST_CHECK_EQUAL(copy.str, blah.str);
+    BOOST_CHECK_EQUAL(copy.vec.size(), 2u);
+    BOOST_CHECK_EQUAL(copy.vec[1].i, -2);
+    BOOST_CHECK_EQUAL(copy.map["x"].i, 3);
+}
+
+BOOST_AUTO_TEST_CASE(numbers)
+{
+    auto format = [] (double value) {
+        char buffer[json::NumberBufferSize];
+        return std::string(buffer, json::formatFloat(value, buffer));
+    };
+
+    BOOST_CHECK_EQUAL(format(0.0), "0.0");
+    BOOST_CHECK_EQUAL(format(-0.0), "-0.0");
+    BOOST_CHECK_EQUAL(format(0.1), "0.1");
+    BOOST_CHECK_EQUAL(format(100), "100.0");
+    BOOST_CHECK_EQUAL(format(-1.5e-7), "-1.5e-7");
+    BOOST_CHECK_EQUAL(format(1e300), "1e300");
+    BOOST_CHECK_EQUAL(format(1.0 / 0.0), "null");
+
+    auto parse = [] (const std::string& str) {
+        return json::parseFloat(str.data(), str.size());
+    };
+
+    const std::vector<std::string> inputs = {
+        "0", "-0", "1", "0.1", "-12.5e-3", "1E+2", "1e22", "1e23",
+        "9007199254740993", "123456789012345678901234", "5e-324",
+        "2.2250738585072014e-308", "1.7976931348623157e308",
+    };
+
+    for (const std::string& str : inputs) {
+        double value = parse(str);
+        BOOST_CHECK_EQUAL(value, strtod(str.c_str(), nullptr));
+        BOOST_CHECK_EQUAL(parse(format(value)), value);
+    }
+
+    // Parsing isn't null terminated.
+    BOOST_CHECK_EQUAL(json::parseFloat("1.25", 3), 1.2);
+
+    BOOST_CHECK_EQUAL(json::parseInt("-9223372036854775808", 20), LONG_MIN);
+    BOOST_CHECK_EQUAL(
+            json::parseUInt("18446744073709551615", 20), ULONG_MAX);
+
+    char buffer[json::NumberBufferSize];
+    size_t len = json::formatInt(LONG_MIN, buffer);
+    BOOST_CHECK_EQUAL(std::string(buffer, len), "-9223372036854775808");
+}
+
+BOOST_AUTO_TEST_CASE(writer)
+{
+    Blah blah;
+    blah.str = std::string(1000, 'x');
+    for (int i = 0; i < 100; ++i) blah.vec.emplace_back(i, i % 2);
+
+    std::string expected = json::print(blah, true);
+
+    json::StringWriter str(1);
+    json::print(blah, str, true);
+    BOOST_CHECK_EQUAL(str.str(), expected);
+
+    std::stringstream ss;
+    json::print(blah, ss, true);
+    BOOST_CHECK_EQUAL(ss.str(), expected);
+
+    FILE* file = tmpfile();
+    {
+        json::FdWriter fd(fileno(file), 1);
+        json::print(blah, fd, true);
+        fd.flush();
+    }
+
+    std::string result(expected.size() + 1, '\0');
+    rewind(file);
+    result.resize(fread(&result[0], 1, result.size(), file));
+    fclose(file);
+
+    BOOST_CHECK_EQUAL(result, expected);
+
+    // Write errors are ignored on destruction and only raised by flush().
+    {
+        json::FdWriter bad(-1);
+        json::print(blah, bad, true);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(lines)
+{
+    std::stringstream ss;
+    for (int i = 0; i < 1000; ++i) {
+        ss << "{\"i\":" << i << ",\"b\":" << (i % 2 ? "true" : "false");
+        ss << "}\n";
+        if (i % 10 == 0) ss << "  \n";
+    }
+    ss << "{\"i\":1000}";
+    std::string buffer = ss.str();
+
+    for (size_t n = 1; n < 16; ++n) {
+        auto ranges = json::splitLines(buffer.data(), buffer.size(), n);
+        BOOST_CHECK_LE(ranges.size(), n);
+        BOOST_CHECK_EQUAL(ranges.front().first, buffer.data());
+        BOOST_CHECK_EQUAL(ranges.back().last, buffer.data() + buffer.size());
+
+        for (size_t i = 1; i < ranges.size(); ++i) {
+            BOOST_CHECK_EQUAL(ranges[i].first, ranges[i - 1].last);
+            BOOST_CHECK_EQUAL(ranges[i].first[-1], '\n');
+        }
+
+        auto values = json::parseLines<Bleh>(buffer, n);
+        BOOST_REQUIRE_EQUAL(values.size(), 1001u);
+
+        for (size_t i = 0; i < values.size(); ++i) {
+            BOOST_CHECK_EQUAL(values[i].i, long(i));
+            BOOST_CHECK_EQUAL(values[i].b, i < 1000 && i % 2);
+        }
+    }
+
+    BOOST_CHECK(json::parseLines<Bleh>("").empty());
+}
+
+BOOST_AUTO_TEST_CASE(errors)
+{
+    auto check = [] (
+            const std::string& json,
+            size_t row, size_t col, const std::string& path)
+    {
+        Blah blah;
+        std::vector<json::Error> errors;
+
+        BOOST_CHECK(!json::parseInto(blah, json, errors));
+        BOOST_REQUIRE_EQUAL(errors.size(), 1u);
+
+        const json::Error& error = errors.front();
+        std::cerr << error.print() << std::endl;
+
+        BOOST_CHECK_EQUAL(error.pos.row, row);
+        BOOST_CHECK_EQUAL(error.pos.col, col);
+        BOOST_CHECK_EQUAL(error.path, path);
+    };
+
+    check("{\"str\":\"abc", 0, 8, "/str");
+    check("{\"vec\":[{\"i\":1},\n{\"i\":tru}]}", 1, 6, "/vec/1/i");
+    check("{\"vec\":[{\"i\":1},{\"x\":1}]}", 0, 20, "/vec/1");
+    check("{\"map\":{\"a/b\":{\"i\":99999999999999999999}}}", 0, 39,
+            "/map/a~1b/i");
+    check("{\"map\":{\"a\":{\"b\":\"x\"}}}", 0, 20, "/map/a/b");
+    check("{\"str\":-}", 0, 8, "/str");
+
+    Blah blah;
+    std::vector<json::Error> errors;
+    BOOST_CHECK(json::parseInto(blah, "{\"str\":\"x\"}", errors));
+    BOOST_CHECK(errors.empty());
+
+    // Errors raised by the reflected setters are reported as well.
+    Guarded guarded;
+    BOOST_CHECK(!json::parseInto(guarded, "{\"value\":-1}", errors));
+    BOOST_REQUIRE_EQUAL(errors.size(), 1u);
+    BOOST_CHECK_NE(errors[0].message.find("negative value <-1>"),
+            std::string::npos);
+    errors.clear();
+
+    std::string lines =
+        "{\"i\":1}\n"
+        "{\"i\":true}\n"
+        "\n"
+        "{\"i\":3}\n"
+        "{\"j\":4}\n";
+
+    auto values = json::parseLines<Bleh>(lines, 2, &errors);
+    BOOST_REQUIRE_EQUAL(values.size(), 2u);
+    BOOST_CHECK_EQUAL(values[0].i, 1);
+    BOOST_CHECK_EQUAL(values[1].i, 3);
+
+    BOOST_REQUIRE_EQUAL(errors.size(), 2u);
+    BOOST_CHECK_EQUAL(errors[0].pos.row, 1u);
+    BOOST_CHECK_EQUAL(errors[0].path, "/i");
+    BOOST_CHECK_EQUAL(errors[1].pos.row, 4u);
+
+    // Without errors, the first one is raised with its row.
+    try {
+        json::parseLines<Bleh>(lines, 2);
+        BOOST_ERROR("expected parseLines to raise");
+    }
+    catch (const ReflectError& error) {
+        std::string what = error.what();
+        BOOST_CHECK_NE(what.find(": 2:10: /i: "), std::string::npos);
+    }
+}
@@ -74,6 +74,38 @@ reflectType(B)
 }
 
 
+struct In
+{
+    std::vector<A> v;
+    std::vector< std::vector<A> > w;
+
+    In() : w(1)
+    {
+        v.emplace_back(500);
+        v.emplace_back(600);
+        w[0] = v;
+    }
+};
+
+reflectType(In)
+{
+    reflectPlumbing();
+    reflectField(v);
+    reflectField(w);
+}
+
+struct Out
+{
+    In fv() const { return In(); }
+};
+
+reflectType(Out)
+{
+    reflectPlumbing();
+    reflectField(fv);
+}
+
+
 /******************************************************************************/
 /* TESTS                                                                      */
 /******************************************************************************/
@@ -86,6 +118,67 @@ BOOST_AUTO_TEST_CASE(parsing)
     BOOST_CHECK_EQUAL(config::Path("a.0.c").toString(), "a.0.c");
 }
 
+BOOST_AUTO_TEST_CASE(slicing)
+{
+    config::Path path("a.b.c");
+    BOOST_CHECK_EQUAL(path.popFront().toString(), "b.c");
+    BOOST_CHECK_EQUAL(path.popBack().toString(), "a.b");
+    BOOST_CHECK_EQUAL(path.popFront().popBack().toString(), "b");
+    BOOST_CHECK(path.popFront().popFront().popFront().empty());
+
+    BOOST_CHECK_EQUAL(path.popBack().pushBack(Symbol("d")).toString(), "a.b.d");
+    BOOST_CHECK_EQUAL(config::Path(path.popFront(), 10).toString(), "b.c.10");
+    BOOST_CHECK_EQUAL(config::Path(path, "d.e").toString(), "a.b.c.d.e");
+    BOOST_CHECK_EQUAL(path.toString(), "a.b.c");
+
+    BOOST_CHECK(path.popBack() < path);
+    BOOST_CHECK(path < config::Path("a.c"));
+    BOOST_CHECK(path < path.popFront().popBack());
+    BOOST_CHECK(config::Path("a.ba") < config::Path("a.bb.c"));
+
+    // Long paths are shared between their slices.
+    config::Path longPath("a.b.c.d.e.f");
+    BOOST_CHECK_EQUAL(longPath.popFront().popBack().toString(), "b.c.d.e");
+    BOOST_CHECK_EQUAL(
+            longPath.pushBack(Symbol("g")).toString(), "a.b.c.d.e.f.g");
+    BOOST_CHECK_EQUAL(
+            path.pushBack(Symbol("d")).pushBack(Symbol("e")).toString(),
+            "a.b.c.d.e");
+    BOOST_CHECK(longPath.popBack() < longPath);
+}
+
+BOOST_AUTO_TEST_CASE(indexes)
+{
+    // Indexes are kept out of the symbol table.
+    config::Path path("a.31415926.b");
+    BOOST_CHECK(Symbol::find("31415926").empty());
+    BOOST_CHECK(!path.isIndex(0));
+    BOOST_CHECK( path.isIndex(1));
+    BOOST_CHECK_EQUAL(path.index(1), 31415926u);
+    BOOST_CHECK_EQUAL(path[1], "31415926");
+    BOOST_CHECK(path.findSymbol(1).empty());
+
+    config::Path indexed(path, 27182818);
+    BOOST_CHECK(Symbol::find("27182818").empty());
+    BOOST_CHECK_EQUAL(indexed.toString(), "a.31415926.b.27182818");
+    BOOST_CHECK_EQUAL(indexed.index(3), 27182818u);
+
+    // Ordered by characters like any other component.
+    BOOST_CHECK(config::Path("a.10") < config::Path("a.2"));
+    BOOST_CHECK(!(config::Path("a.2") < config::Path("a.2")));
+    BOOST_CHECK(path.sameComponent(1, indexed));
+    BOOST_CHECK( config::Path("a.1").pushBack(Symbol("7")).isIndex(2));
+
+    // Too large to be an index.
+    config::Path big("a.99999999999999999999");
+    BOOST_CHECK(!big.isIndex(1));
+    BOOST_CHECK_EQUAL(big[1], "99999999999999999999");
+
+    // Only interned once the symbol is requested.
+    BOOST_CHECK_EQUAL(path.symbol(1), Symbol("31415926"));
+    BOOST_CHECK_EQUAL(path.findSymbol(1), Symbol("31415926"));
+}
+
 BOOST_AUTO_TEST_CASE(has)
 {
     Value a = type<A>()->construct();
@@ -234,3 +327,58 @@ BOOST_AUTO_TEST_CASE(set)
 }
 
 
+
+BOOST_AUTO_TEST_CASE(compiled)
+{
+    auto compile = [] (const char* path) {
+        return config::CompiledPath(type<B>(), path);
+    };
+
+    Value vB = type<B>()->construct();
+    B& b = vB.cast<B>();
+
+    BOOST_CHECK( compile("p.i").has(vB));
+    BOOST_CHECK(!compile("p.d").has(vB));
+    BOOST_CHECK( compile("fr.i").has(vB));
+    BOOST_CHECK( compile("v.1.i").has(vB));
+    BOOST_CHECK(!compile("v.2").has(vB));
+    BOOST_CHECK(!compile("v.x").has(vB));
+    BOOST_CHECK( compile("m.x.i").has(vB));
+    BOOST_CHECK(!compile("m.y.i").has(vB));
+
+    BOOST_CHECK_EQUAL( compile("p.i").get(vB).get<int>(), b.p->i);
+    BOOST_CHECK_EQUAL( compile("fp.i").get(vB).get<int>(), b.fp()->i);
+    BOOST_CHECK_EQUAL(&compile("fr").get(vB).get<A>(), &b.fr());
+    BOOST_CHECK_EQUAL(&compile("v.1").get(vB).get<A>(), &b.v[1]);
+    BOOST_CHECK_EQUAL(&compile("m.x").get(vB).get<A>(), &b.m["x"]);
+
+    auto path = compile("v.3.i");
+    path.set(vB, 27);
+    BOOST_CHECK_EQUAL(b.v.at(3).i, 27);
+    BOOST_CHECK_EQUAL(path.get(vB).get<int>(), 27);
+
+    compile("m.z.i").set(vB, 28);
+    BOOST_CHECK_EQUAL(b.m["z"].i, 28);
+
+    // Values of a different type are walked dynamically.
+    Value vA = type<A>()->construct();
+    auto other = compile("i");
+    BOOST_CHECK(other.has(vA));
+    BOOST_CHECK_EQUAL(other.get(vA).get<int>(), vA.get<A>().i);
+
+    // Paths compiled from a config skip the key.
+    config::Config cfg;
+    cfg.set("b", vB);
+    auto cpath = cfg.compile("b.v.0.i");
+    BOOST_CHECK(cfg.count(cpath));
+    BOOST_CHECK_EQUAL(cfg[cpath].get<int>(), b.v[0].i);
+
+    // Values returned by value must outlive the steps that walk into them.
+    Value vOut = type<Out>()->construct();
+    BOOST_CHECK( config::CompiledPath(type<Out>(), "fv.v.1").has(vOut));
+    BOOST_CHECK( config::CompiledPath(type<Out>(), "fv.v.1.i").has(vOut));
+    BOOST_CHECK(!config::CompiledPath(type<Out>(), "fv.v.2").has(vOut));
+    BOOST_CHECK( config::CompiledPath(type<Out>(), "fv.w.0.1").has(vOut));
+    BOOST_CHECK(!config::CompiledPath(type<Out>(), "fv.w.0.2").has(vOut));
+    BOOST_CHECK( config::has(vOut, "fv.v.0.i"));
+}
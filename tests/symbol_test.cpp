@@ -0,0 +1,96 @@
+/* symbol_test.cpp                                 -*- C++ -*-
+   agent (agent@local), 18 Oct 2026
+   FreeBSD-style copyright and disclaimer apply
+
+   Tests for Symbol.
+*/
+
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#define REFLECT_USE_EXCEPTIONS 1
+
+#include "reflect.h"
+
+#include <boost/test/unit_test.hpp>
+#include <thread>
+
+using namespace std;
+using namespace reflect;
+
+
+/******************************************************************************/
+/* BASICS                                                                     */
+/******************************************************************************/
+
+BOOST_AUTO_TEST_CASE(basics)
+{
+    Symbol empty;
+    BOOST_CHECK(empty.empty());
+    BOOST_CHECK_EQUAL(empty.str(), "");
+    BOOST_CHECK(empty == Symbol(""));
+    BOOST_CHECK(empty == Symbol(std::string()));
+
+    Symbol foo("foo");
+    BOOST_CHECK(!foo.empty());
+    BOOST_CHECK_EQUAL(foo.str(), "foo");
+    BOOST_CHECK(foo != empty);
+
+    std::string str = "fo";
+    str += "o";
+    BOOST_CHECK(Symbol(str) == foo);
+    BOOST_CHECK_EQUAL(&Symbol(str).str(), &foo.str());
+    BOOST_CHECK_EQUAL(Symbol(str).hash(), foo.hash());
+
+    Symbol bar("bar");
+    BOOST_CHECK(bar != foo);
+    BOOST_CHECK((bar < foo) != (foo < bar));
+
+    std::unordered_map<Symbol, int> map;
+    map[foo] = 1;
+    map[bar] = 2;
+    BOOST_CHECK_EQUAL(map[Symbol("foo")], 1);
+    BOOST_CHECK_EQUAL(map[Symbol("bar")], 2);
+}
+
+
+/******************************************************************************/
+/* FIND                                                                       */
+/******************************************************************************/
+
+BOOST_AUTO_TEST_CASE(find_)
+{
+    BOOST_CHECK(!(std::is_convertible<const char*, Symbol>::value));
+    BOOST_CHECK(!(std::is_convertible<std::string, Symbol>::value));
+
+    BOOST_CHECK(Symbol::find("").empty());
+    BOOST_CHECK(Symbol::find("never-interned-symbol").empty());
+
+    // Looking up a string must not intern it.
+    BOOST_CHECK(Symbol::find("never-interned-symbol").empty());
+
+    Symbol sym("interned-symbol");
+    BOOST_CHECK(Symbol::find("interned-symbol") == sym);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_intern)
+{
+    enum { Threads = 4, Symbols = 2000 };
+
+    std::vector< std::vector<Symbol> > results(Threads);
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < Threads; ++i) {
+        threads.emplace_back([&, i] {
+            for (size_t j = 0; j < Symbols; ++j)
+                results[i].emplace_back("concurrent-" + std::to_string(j));
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    for (size_t j = 0; j < Symbols; ++j) {
+        std::string str = "concurrent-" + std::to_string(j);
+        BOOST_CHECK(Symbol::find(str) == results[0][j]);
+        for (size_t i = 1; i < Threads; ++i)
+            BOOST_CHECK(results[i][j] == results[0][j]);
+    }
+}
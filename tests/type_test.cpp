@@ -13,6 +13,7 @@
 #include "test_types.h"
 
 #include <boost/test/unit_test.hpp>
+#include <thread>
 
 using namespace std;
 using namespace reflect;
@@ -31,6 +32,33 @@ BOOST_AUTO_TEST_CASE(void_)
     BOOST_CHECK(!t->isMovable());
 }
 
+// Must run before any other test loads the hierarchy of test::Child.
+BOOST_AUTO_TEST_CASE(concurrentLoad)
+{
+    enum { Threads = 8 };
+
+    std::vector<const Type*> types(Threads, nullptr);
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < Threads; ++i) {
+        threads.emplace_back([&, i] { types[i] = type<test::Child>(); });
+    }
+
+    for (auto& thread : threads) thread.join();
+
+    // Boost.Test assertions aren't thread-safe so check from the main thread.
+    for (const Type* t : types) {
+        BOOST_CHECK_EQUAL(t, type<test::Child>());
+        BOOST_CHECK(t->isFrozen());
+        BOOST_CHECK(t->hasField("childValue"));
+        BOOST_CHECK(t->isChildOf<test::Parent>());
+    }
+
+    // Adding a type that was already loaded doesn't replace it.
+    Registry::add<test::Child>();
+    BOOST_CHECK_EQUAL(Registry::get("test::Child"), types.front());
+}
+
 BOOST_AUTO_TEST_CASE(print)
 {
     std::cerr << type<int>()->print() << std::endl;
@@ -137,6 +165,62 @@ BOOST_AUTO_TEST_CASE(fieldType)
     BOOST_CHECK_EQUAL(tChild->fieldType("shadowed"), type<bool>());
 }
 
+BOOST_AUTO_TEST_CASE(fieldDescriptors)
+{
+    const Type* tChild = type<test::Child>();
+
+    const auto& fields = tChild->fieldDescriptors();
+    BOOST_CHECK_EQUAL(fields.size(), 3u);
+    BOOST_CHECK_EQUAL(fields[0].name.str(), "childValue");
+    BOOST_CHECK_EQUAL(fields[1].name.str(), "shadowed");
+    BOOST_CHECK_EQUAL(fields[2].name.str(), "value");
+
+    for (const auto& field : fields) {
+        BOOST_CHECK(field.getter);
+        BOOST_CHECK(field.setter);
+        BOOST_CHECK(field.hasOffset());
+    }
+
+    BOOST_CHECK(!tChild->fieldDescriptor("blah"));
+
+    test::Child child(test::Object(1), true);
+    child.value = test::Object(3);
+    Value value(child);
+
+    const FieldDescriptor* shadowed = tChild->fieldDescriptor("shadowed");
+    BOOST_CHECK_EQUAL(shadowed->type, type<bool>());
+    BOOST_CHECK_EQUAL(&value.field(*shadowed).get<bool>(), &child.shadowed);
+
+    const FieldDescriptor* parentValue = tChild->fieldDescriptor("value");
+    BOOST_CHECK_EQUAL(parentValue->type, type<test::Object>());
+    BOOST_CHECK_EQUAL(&value.field(*parentValue).get<test::Object>(), &child.value);
+
+    // Getter and setter functions have no offset.
+    const FieldDescriptor* objValue = type<test::Object>()->fieldDescriptor("value");
+    BOOST_CHECK(!objValue->hasOffset());
+    BOOST_CHECK(objValue->getter);
+    BOOST_CHECK(objValue->setter);
+    BOOST_CHECK_EQUAL(objValue->type, type<int>());
+
+    Value obj(test::Object(10));
+    BOOST_CHECK_EQUAL(obj.field(*objValue).get<int>(), 10);
+
+    // Fields read in place keep the object they belong to alive.
+    Value field;
+    {
+        Value tmp(test::Child(test::Object(5), true));
+        field = tmp.field(*parentValue);
+    }
+    BOOST_CHECK(field.isStored());
+    BOOST_CHECK_EQUAL(field.get<test::Object>().value(), 0);
+
+    {
+        Value tmp(test::Child(test::Object(5), true));
+        field = tmp.field(*shadowed);
+    }
+    BOOST_CHECK_EQUAL(field.get<bool>(), true);
+}
+
 BOOST_AUTO_TEST_CASE(moveCopy)
 {
     const Type* tInt = type<int>();
@@ -210,3 +294,133 @@ BOOST_AUTO_TEST_CASE(converter)
     BOOST_CHECK( tConvertible->hasConverter<test::Parent>());
     BOOST_CHECK(!tConvertible->hasConverter<test::Convertible>());
 }
+
+BOOST_AUTO_TEST_CASE(traits)
+{
+    BOOST_CHECK(Trait::find("pointer") == Trait::Pointer);
+    BOOST_CHECK_EQUAL(Trait(Trait::Field).name().str(), "field");
+
+    const Type* tInt = type<int>();
+    BOOST_CHECK( tInt->is(Trait::Primitive));
+    BOOST_CHECK( tInt->is(Trait::Integer));
+    BOOST_CHECK( tInt->is("integer"));
+    BOOST_CHECK(!tInt->is(Trait::Float));
+    BOOST_CHECK( type<test::Object>()->functionIs("value", Trait::Field));
+
+    // Enough traits to spill out of the first word of the bitset.
+    Type type("traits");
+    for (size_t i = 0; i < 100; i += 2)
+        type.addTrait("trait_" + std::to_string(i));
+
+    for (size_t i = 0; i < 100; ++i)
+        BOOST_CHECK_EQUAL(type.is("trait_" + std::to_string(i)), !(i % 2));
+
+    BOOST_CHECK_EQUAL(type.traits().size(), 50u);
+
+    // Querying a trait doesn't register it.
+    BOOST_CHECK(!type.is("never_added"));
+    BOOST_CHECK(!Trait::find("never_added").isRegistered());
+    BOOST_CHECK(Symbol::find("never_added").empty());
+
+    BOOST_CHECK(Trait::add("now_added").isRegistered());
+    BOOST_CHECK(Trait::find("now_added") == Trait::add("now_added"));
+}
+
+BOOST_AUTO_TEST_CASE(freeze)
+{
+    BOOST_CHECK(type<test::Child>()->isFrozen());
+
+    Type parent("parent");
+    parent.add("foo", [] { return 1; });
+    parent.add("bar", [] { return 2; });
+    parent.addFunctionTrait("bar", "blah");
+    parent.freeze();
+
+    Type child("child", &parent);
+    child.add("bar", [] { return 3; });
+    child.add("baz", [] (const int& i) { return i; });
+    child.addFunctionTrait("baz", Trait::Field);
+
+    for (size_t i = 0; i < 2; ++i) {
+        BOOST_CHECK_EQUAL(child.isFrozen(), i == 1);
+
+        BOOST_CHECK(child.hasFunction("foo"));
+        BOOST_CHECK(!child.hasFunction("blah"));
+        BOOST_CHECK_EQUAL(child.call<int>("foo"), 1);
+        BOOST_CHECK_EQUAL(child.call<int>("bar"), 3);
+
+        BOOST_CHECK(child.functionIs("bar", "blah"));
+        BOOST_CHECK(child.hasField("baz"));
+        BOOST_CHECK(!child.hasField("bar"));
+
+        auto fns = child.functions();
+        BOOST_CHECK_EQUAL(fns.size(), 3u);
+        BOOST_CHECK_EQUAL(fns[0], "bar");
+        BOOST_CHECK_EQUAL(fns[2], "foo");
+
+        auto fields = child.fields();
+        BOOST_CHECK_EQUAL(fields.size(), 1u);
+        BOOST_CHECK_EQUAL(fields[0], "baz");
+
+        child.freeze();
+    }
+
+    const auto& fns = child.functions();
+    BOOST_CHECK_EQUAL(&fns, &child.functions());
+
+    const FieldDescriptor* baz = child.fieldDescriptor("baz");
+    BOOST_CHECK(baz);
+
+    child.add("blah", [] { return 4; });
+    BOOST_CHECK(!child.isFrozen());
+    BOOST_CHECK_EQUAL(child.call<int>("blah"), 4);
+
+    // The old tables outlive the modification and new ones are built lazily.
+    BOOST_CHECK_EQUAL(fns.size(), 3u);
+    BOOST_CHECK_EQUAL(child.functions().size(), 4u);
+    BOOST_CHECK(child.isFrozen());
+
+    // Descriptors that were handed out are never freed.
+    BOOST_CHECK_EQUAL(baz->name.str(), "baz");
+    BOOST_CHECK_EQUAL(child.fieldDescriptors().size(), 1u);
+    BOOST_CHECK_NE(child.fieldDescriptor("baz"), baz);
+}
+
+BOOST_AUTO_TEST_CASE(overloads)
+{
+    Value obj = type<test::Object>()->construct(10);
+
+    // Resolutions are cached after the first call so go through them twice.
+    for (size_t i = 0; i < 2; ++i) {
+        BOOST_CHECK_EQUAL(obj.get<int>("value"), 10);
+
+        obj.set("value", 20);
+        BOOST_CHECK_EQUAL(obj.get<int>("value"), 20);
+        obj.set("value", 10);
+
+        BOOST_CHECK_THROW(obj.set("value", test::Parent()), ReflectError);
+        BOOST_CHECK_THROW(obj.call<void>("value", 1, 2), ReflectError);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(bind_)
+{
+    const Type* tObject = type<test::Object>();
+
+    auto get = tObject->bind<int(const test::Object&)>("value");
+    auto set = tObject->bind<void(test::Object&, int)>("value");
+    BOOST_CHECK(get);
+    BOOST_CHECK(set);
+
+    test::Object obj(10);
+    BOOST_CHECK_EQUAL(get(obj), 10);
+
+    set(obj, 20);
+    BOOST_CHECK_EQUAL(obj.value(), 20);
+    BOOST_CHECK_EQUAL(get(obj), 20);
+
+    BOOST_CHECK(!BoundFunction<int()>());
+
+    typedef void BadFn(test::Object&, test::Parent);
+    BOOST_CHECK_THROW(tObject->bind<BadFn>("value"), ReflectError);
+}
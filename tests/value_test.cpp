@@ -13,6 +13,7 @@
 #include "test_types.h"
 
 #include <boost/test/unit_test.hpp>
+#include <thread>
 
 using namespace std;
 using namespace reflect;
@@ -131,6 +132,57 @@ BOOST_AUTO_TEST_CASE(destruct)
 }
 
 
+/******************************************************************************/
+/* INLINE                                                                     */
+/******************************************************************************/
+
+BOOST_AUTO_TEST_CASE(inline_)
+{
+    Value a(10);
+    BOOST_CHECK(a.isStored());
+    BOOST_CHECK_EQUAL(a.get<int>(), 10);
+
+    // Moving an inline value relocates it.
+    Value b = std::move(a);
+    BOOST_CHECK(b.isStored());
+    BOOST_CHECK_NE(b.value(), a.value());
+    BOOST_CHECK_EQUAL(b.get<int>(), 10);
+
+    // Moved-from values are left empty.
+    BOOST_CHECK(!a.isStored());
+    BOOST_CHECK(a.isVoid());
+
+    // Copies must still refer to the same object.
+    Value c = b;
+    BOOST_CHECK_EQUAL(c.value(), b.value());
+
+    c.cast<int>() = 20;
+    BOOST_CHECK_EQUAL(b.get<int>(), 20);
+
+    Value d;
+    d = c;
+    BOOST_CHECK_EQUAL(d.value(), b.value());
+}
+
+BOOST_AUTO_TEST_CASE(inline_concurrent_copies)
+{
+    enum { Threads = 4 };
+
+    for (size_t round = 0; round < 100; ++round) {
+        Value value(10);
+        std::vector<Value> copies(Threads);
+
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < Threads; ++i)
+            threads.emplace_back([&, i] { copies[i] = value; });
+        for (auto& thread : threads) thread.join();
+
+        for (const auto& copy : copies)
+            BOOST_CHECK_EQUAL(copy.value(), value.value());
+    }
+}
+
+
 /******************************************************************************/
 /* LVALUE                                                                     */
 /******************************************************************************/